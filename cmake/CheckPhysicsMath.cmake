@@ -0,0 +1,24 @@
+# Fails the build when the physics library calls one of the sf::Vector2 functions that SFML builds in sfml-system.
+# sfml-system doesn't get the SWB_DETERMINISTIC_PHYSICS float options, so with another SFML build (or another machine)
+# those can round differently. The physics uses the inline versions in math.hpp instead: getLength(), getNormalized() and rotateVector().
+# math.hpp itself isn't checked, because rotateVector() calls rotatedBy() outside of SWB_DETERMINISTIC_PHYSICS.
+#
+# Runs as a script: cmake -DFILES=<file|file|...> -DSTAMP=<file> -P CheckPhysicsMath.cmake
+
+string(REPLACE "|" ";" FILES "${FILES}")
+set(FORBIDDEN "\\.(length|normalized|angle|angleTo|rotatedBy|projectedOnto)\\(")
+
+set(FOUND "")
+foreach(FILE ${FILES})
+  file(STRINGS ${FILE} LINES REGEX "${FORBIDDEN}")
+  foreach(LINE ${LINES})
+    string(STRIP "${LINE}" LINE)
+    string(APPEND FOUND "\n  ${FILE}: ${LINE}")
+  endforeach()
+endforeach()
+
+if(FOUND)
+  message(FATAL_ERROR "The physics calls sf::Vector2 functions from sfml-system. Use getLength(), getNormalized() or rotateVector() from math.hpp:${FOUND}")
+endif()
+
+file(TOUCH ${STAMP})
@@ -1,14 +1,118 @@
 #ifndef AUDIO_H_
 #define AUDIO_H_
 
+#include <SFML/Audio/Sound.hpp>
 #include <SFML/Audio/SoundBuffer.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
-/**
- * @brief Plays a sound from a buffer
- * @attention Run this function in a thread
- * 
- * @param buffer The sound buffer 
- */
-void playSound(sf::SoundBuffer buffer);
+// Plays the sounds of the game. A fixed number of voices (sf::Sounds) belongs to one audio thread.
+// The other threads only put a play event in a lock-free queue, so playing a sound doesn't start a thread, allocate or wait for a lock.
 
-#endif //AUDIO_H_
\ No newline at end of file
+class AudioEngine {
+public:
+
+  // The number of sounds that can play at the same time. When all of them are busy, the one that has played the longest is cut off
+  static constexpr unsigned short NUM_VOICES = 16;
+  // The number of play events that can wait for the audio thread. Has to be a power of 2
+  static constexpr unsigned short QUEUE_SIZE = 64;
+  // The audio thread checks for new events at least this often, also when nobody wakes it up
+  static constexpr unsigned short IDLE_WAIT_MS = 10;
+
+  AudioEngine();
+
+  /**
+   * @brief Destroy the Audio Engine object. Stops the audio thread
+   *
+   */
+  ~AudioEngine();
+
+  AudioEngine(const AudioEngine&) = delete;
+  AudioEngine& operator=(const AudioEngine&) = delete;
+
+  /**
+   * @brief Starts the audio thread. Sounds that are played before this wait in the queue
+   *
+   */
+  void start();
+
+  /**
+   * @brief Stops all sounds and the audio thread
+   *
+   */
+  void stop();
+
+  /**
+   * @brief Plays a sound at Globals::volume. Can be called from any thread
+   *
+   * @param buffer The sound. The voice shares it while playing, so it isn't copied and can't be freed too early
+   * @return true if the sound was queued
+   * @return false if the queue is full. The sound is dropped
+   */
+  bool play(const std::shared_ptr<const sf::SoundBuffer>& buffer);
+
+private:
+
+  struct PlayEvent {
+    std::shared_ptr<const sf::SoundBuffer> buffer;
+    float volume = 100.f;
+  };
+
+  // A slot of the queue. sequence tells whose turn it is: the slot is free for push number sequence and full for pop number sequence - 1
+  struct Slot {
+    std::atomic<size_t> sequence{0};
+    PlayEvent event;
+  };
+
+  struct Voice {
+    std::unique_ptr<sf::Sound> sound;
+    std::shared_ptr<const sf::SoundBuffer> buffer; // Keeps the buffer alive while the sound plays
+    uint64_t startedAt = 0;
+  };
+
+  /**
+   * @brief Takes the next event out of the queue. Only the audio thread calls this
+   *
+   * @param event Gets the event
+   * @return true if there was one
+   */
+  bool pop(PlayEvent& event);
+
+  /**
+   * @brief Plays the events in the queue until stop() is called
+   *
+   */
+  void run();
+
+  /**
+   * @brief Finds a voice for a new sound: a stopped one, or else the one that started first
+   *
+   * @return Voice&
+   */
+  Voice& getFreeVoice();
+
+  std::array<Slot, QUEUE_SIZE> slots;
+  std::atomic<size_t> tail{0}; // The next push
+  size_t head = 0; // The next pop
+
+  // A buffer for the voices that aren't playing anything. sf::Sound can't exist without one
+  sf::SoundBuffer silence;
+  std::vector<Voice> voices;
+  uint64_t playCount = 0;
+
+  std::thread thread;
+  std::atomic<bool> running{false};
+  // Only used to wake up the audio thread. The queue itself doesn't need the mutex
+  std::mutex wakeMutex;
+  std::condition_variable wake;
+
+};
+
+#endif //AUDIO_H_
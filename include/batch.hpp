@@ -0,0 +1,229 @@
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../include/physics.hpp"
+#include "../include/trajectory.hpp"
+#include "../include/world.hpp"
+
+/**
+ * @brief A lot of independent balls in one level, stored as separate arrays instead of one Ball object each.
+ * It steps the balls through the colliders of a PhysicsWorld with the same rules as PhysicsWorld::step and PhysicsWorld::tick:
+ * the same sweep, the same bounces and boosts, and the same end conditions. The balls don't collide with each other.
+ * Each ball can have one item of its own on top of the world's colliders, so the LevelSolver runs all the places for an item at once.
+ * It doesn't change the world, so the world can keep being used for the game at the same time.
+ * @attention The arrays are only storage. Every ball still goes through the same per-ball code as the world's ball, one ball after the other,
+ * so a ball isn't much faster here than in PhysicsWorld::tick (compare the two in SorryWereBroke_bench). What it saves the solver is the
+ * adding, removing and loading of items and states in the world for every place it tries
+ * 
+ */
+class BallBatch {
+public:
+
+  /**
+   * @brief Construct a new Ball Batch object
+   * @attention The world has to outlive the batch. Changing the world's colliders between steps is allowed
+   * 
+   * @param newWorld The world with the colliders and the money bags
+   */
+  BallBatch(PhysicsWorld& newWorld) : world(newWorld) {};
+
+  /**
+   * @brief Adds a ball
+   * 
+   * @param position The midpoint of the ball
+   * @param velocity The velocity vector (physics coordinates, so y points up)
+   * @param mass The mass of the ball
+   * @param radius The radius of the ball in pixels
+   * @return size_t The index of the ball
+   */
+  size_t addBall(const sf::Vector2f position, const sf::Vector2f velocity, const float mass, const float radius);
+
+  /**
+   * @brief Adds a ball that continues a run from a state that PhysicsWorld::saveState() stored. It gets the mass and the radius of the world's ball
+   * @attention Throws an std::runtime_error if the state has another number of money bags
+   * 
+   * @param state The state
+   * @param startTick The number of ticks of the run before the state (see getTicks)
+   * @return size_t The index of the ball
+   */
+  size_t addBall(const WorldState& state, const uint32_t startTick = 0);
+
+  /**
+   * @brief Adds a ball that runs a remembered run again with one more item, which only this ball can hit.
+   * Like TrajectoryCache::rewind, the ball starts at the last checkpoint before the ball came near the item.
+   * The run ends exactly like it would in the world with the item added last (see PhysicsWorld::addItem)
+   * @attention The world has to have the same colliders as when the run was remembered. Throws an std::runtime_error for items that don't have physics
+   * 
+   * @param from The run without the item. It has to be made with PhysicsWorld::tick
+   * @param newItem The item
+   * @return size_t The index of the ball
+   */
+  size_t addBall(const TrajectoryCache& from, const Placement& newItem);
+
+  /**
+   * @brief Removes all of the balls. The memory stays reserved for the next batch
+   * 
+   */
+  void clear();
+
+  /**
+   * @brief Moves every ball that is still running forward by deltaTime
+   * 
+   * @param deltaTime The time to simulate in seconds
+   * @return size_t The number of balls that are still running
+   */
+  size_t step(const float deltaTime);
+
+  /**
+   * @brief Moves every ball that is still running forward by one PhysicsWorld::TICK. Each ball splits the tick into the same steps as PhysicsWorld::tick
+   * 
+   * @param maxTicks A ball stops after this many ticks (see getTicks), even if it's still moving
+   * @return size_t The number of balls that are still running and below maxTicks
+   */
+  size_t tick(const uint32_t maxTicks = UINT32_MAX);
+
+  /**
+   * @brief Get the number of balls
+   * 
+   * @return size_t 
+   */
+  size_t size() {return positionX.size();};
+
+  /**
+   * @brief Get the midpoint of a ball
+   * 
+   * @param i The index of the ball
+   * @return sf::Vector2f 
+   */
+  sf::Vector2f getPosition(const size_t i) {return {positionX[i], positionY[i]};};
+
+  /**
+   * @brief Get the velocity vector of a ball
+   * 
+   * @param i The index of the ball
+   * @return sf::Vector2f 
+   */
+  sf::Vector2f getVelocity(const size_t i) {return {velocityX[i], velocityY[i]};};
+
+  /**
+   * @brief Returns whether a ball has finished its run (came to a rest or left the level)
+   * 
+   * @param i The index of the ball
+   */
+  bool isFinished(const size_t i) {return finished[i];};
+
+  /**
+   * @brief Get the number of ticks of a ball's run, including the ones before its start state
+   * 
+   * @param i The index of the ball
+   * @return uint32_t 
+   */
+  uint32_t getTicks(const size_t i) {return ticks[i];};
+
+  /**
+   * @brief Get the total value of the money bags that a ball collected
+   * 
+   * @param i The index of the ball
+   * @return uint16_t 
+   */
+  uint16_t getCollectedValue(const size_t i);
+
+  /**
+   * @brief Returns whether a ball collected a money bag
+   * 
+   * @param i The index of the ball
+   * @param bag The index of the money bag in PhysicsWorld::getMoneyBags()
+   */
+  bool hasCollected(const size_t i, const size_t bag) {return collected[i * numBags + bag];};
+
+private:
+
+  // The key of a ball's own item. It's never a key in the grid, and it gets tested after the grid's colliders, like the world's newest item
+  static constexpr size_t ITEM_KEY = PhysicsWorld::USER_KEY - 1;
+  // A ball without an item of its own
+  static constexpr size_t NO_ITEM = SIZE_MAX;
+
+  /**
+   * @brief Get a collider that a ball can hit (see PhysicsWorld::getCollider)
+   * 
+   * @param i The index of the ball
+   * @param key The key in the grid, or ITEM_KEY for the ball's own item
+   * @param isBooster Gets set to whether the collider is a booster
+   * @return PhysicsObjects::BouncyObject& The collider. Cast it to a Booster if isBooster is true
+   */
+  PhysicsObjects::BouncyObject& getCollider(const size_t i, const size_t key, bool& isBooster);
+
+  /**
+   * @brief Applies gravity to one ball. This is the same as Ball::applyForce in PhysicsWorld::step
+   * 
+   * @param i The index of the ball
+   * @param deltaTime The time of the step
+   */
+  void applyGravity(const size_t i, const float deltaTime);
+
+  /**
+   * @brief Moves one ball after the gravity, checks if its run has finished and collects the money bags it touches
+   * 
+   * @param i The index of the ball
+   * @param deltaTime The time of the step
+   * @return true if the ball is still running
+   */
+  bool move(const size_t i, const float deltaTime);
+
+  /**
+   * @brief Moves one ball, bouncing and boosting it on the way (see PhysicsWorld::sweep)
+   * 
+   * @param i The index of the ball
+   * @param deltaTime The time to move the ball for
+   * @return true if the ball has come to rest against something
+   */
+  bool sweep(const size_t i, float deltaTime);
+
+  /**
+   * @brief Forgets the objects a ball has left and checks if its run has finished (see PhysicsWorld::checkCollisions)
+   * 
+   * @param i The index of the ball
+   * @return true if the run has finished
+   */
+  bool checkCollisions(const size_t i);
+
+  /**
+   * @brief Returns whether a ball is touching (justBounced or justBoosted) an object
+   * 
+   * @param i The index of the ball
+   * @param key The key of the object
+   */
+  bool isTouching(const size_t i, const size_t key);
+
+  PhysicsWorld& world;
+
+  // One entry per ball
+  std::vector<float> positionX, positionY;
+  std::vector<float> velocityX, velocityY;
+  std::vector<float> radius;
+  std::vector<float> mass;
+  std::vector<uint8_t> finished;
+  std::vector<uint32_t> ticks;
+  std::vector<size_t> item; // The index in items, or NO_ITEM
+
+  // The objects that a ball bounced off of or got boosted by and hasn't left yet. That's what justBounced and justBoosted are for one ball.
+  // A list can grow like the world's, so a ball never forgets a booster it's still in (which would boost it again).
+  // clear() keeps the lists of the old balls, so their memory gets reused
+  std::vector<std::vector<size_t>> touchingKeys;
+
+  std::vector<PhysicsWorld::UserObject> items;
+
+  // One entry per ball per money bag, starting at i * numBags
+  size_t numBags = 0;
+  std::vector<uint8_t> collected;
+
+  std::vector<size_t> nearbyKeys; // The result of the last grid query. It's a member so the memory gets reused
+
+};
+
+#endif // BATCH_H_
@@ -10,6 +10,10 @@
 #include "../include/physics.hpp"
 #include "../include/ui.hpp"
 #include "../include/config.hpp"
+#include "../include/preview.hpp"
+#include "../include/render.hpp"
+#include "../include/resources.hpp"
+#include "../include/world.hpp"
 
 namespace UserObjects {
   class EditableObject {
@@ -110,6 +114,20 @@ namespace UserObjects {
      * @return std::filesystem::path
      */
     std::filesystem::path getTexturePath() {return texturePath;};
+
+    /**
+     * @brief Set the ID of the object's copy in the physics world
+     * 
+     * @param newId The new ID
+     */
+    void setWorldId(const size_t newId) {worldId = newId;};
+
+    /**
+     * @brief Get the ID of the object's copy in the physics world
+     * 
+     * @return size_t 
+     */
+    size_t getWorldId() {return worldId;};
     
     /**
      * @brief Checks if the editable object is clicked on
@@ -123,8 +141,9 @@ namespace UserObjects {
     /**
      * @brief Draws the object on the screen
      * 
+     * @param queue The queue that gets the sprite. Where it ends up depends on where the queue is flushed: the window or a scene layer (see SceneLayers)
      */
-    void draw();
+    void draw(RenderQueue& queue);
 
   private:
 
@@ -133,7 +152,7 @@ namespace UserObjects {
     sf::Vector2i pos;
     sf::Vector2f size;
     std::filesystem::path texturePath;
-    sf::Texture texture;
+    SpriteRegion sprite; // Shares its texture with the other objects of the same item
     float rotation = 0;
 
     // BouncyObject (optional)
@@ -145,6 +164,8 @@ namespace UserObjects {
     bool booster = false;
     PhysicsObjects::Booster boost;
 
+    size_t worldId = 0;
+
   };
 
   // Just a small class to keep track of all of the user's placed objects
@@ -156,13 +177,33 @@ namespace UserObjects {
      * 
      */
     ~EditableObjectList();
+
+    /**
+     * @brief Set the physics world. Every object that gets added or removed is also added to or removed from this world
+     * 
+     * @param newWorld The physics world
+     */
+    void setWorld(PhysicsWorld* newWorld) {world = newWorld;};
     
     /**
      * @brief Adds an EditableObject to the list
      * 
      * @param object The editable object
      */
-    void addObject(EditableObject* object) {editableObjects.push_back(object);};
+    void addObject(EditableObject* object);
+
+    /**
+     * @brief Removes an EditableObject from the list and deletes it from memory
+     * 
+     * @param object The editable object
+     */
+    void removeObject(EditableObject* object);
+
+    /**
+     * @brief Removes and deletes all of the EditableObjects
+     * 
+     */
+    void clear();
 
     /**
      * @brief Get the EditableObjects
@@ -175,6 +216,8 @@ namespace UserObjects {
 
     std::vector<EditableObject*> editableObjects;
 
+    PhysicsWorld* world = nullptr;
+
   };
 
   class GhostObject {
@@ -220,11 +263,20 @@ namespace UserObjects {
 
     /**
      * @brief A function that is called on the main loop. It updates the position and rotation if the correct key is pressed
+     * and draws the predicted path of the ball with the object at its current position
      * 
      * @param rotateKeyPressed Whether or not one of the rotate keys is pressed
      * @param playerConf The player config object. Used to check the controls
+     * @param world The physics world. The prediction runs on a copy of it
      */
-    void loop(const bool rotateKeyPressed, Config& playerConf);
+    void loop(const bool rotateKeyPressed, Config& playerConf, PhysicsWorld& world);
+
+    /**
+     * @brief Get the trajectory preview
+     * 
+     * @return TrajectoryPreview& 
+     */
+    TrajectoryPreview& getPreview() {return preview;};
 
     /**
      * @brief Places the object that is currently bein built
@@ -242,6 +294,8 @@ namespace UserObjects {
     std::filesystem::path texturePath;
     float rotation = 0;
 
+    TrajectoryPreview preview;
+
   };
 
   /**
@@ -1,18 +1,49 @@
 #ifndef GLOBALS_H_
 #define GLOBALS_H_
 
-#include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/Font.hpp>
 #include <vector>
 #include <thread>
 
+#include "../include/audio.hpp"
+#include "../include/layers.hpp"
+#include "../include/platform.hpp"
+#include "../include/render.hpp"
+#include "../include/resources.hpp"
+
 namespace Globals {
-  extern sf::Font mainFont;
-  extern sf::Font monoFont;
+  /**
+   * @brief Get the font of the game (Noto Sans). It's loaded through the ResourceCache on first use, because global UI elements already need it before main()
+   * @attention Throws an std::runtime_error if the font can't be loaded
+   *
+   * @return const sf::Font&
+   */
+  const sf::Font& getMainFont();
+
+  /**
+   * @brief Get the monospace font of the dialogue (Noto Sans Mono). It's loaded through the ResourceCache on first use
+   * @attention Throws an std::runtime_error if the font can't be loaded
+   *
+   * @return const sf::Font&
+   */
+  const sf::Font& getMonoFont();
 
+  /**
+   * @brief Loads both fonts, so the first text that uses one of them doesn't have to wait for the file
+   * @attention Throws an std::runtime_error if a font can't be loaded
+   *
+   */
   void initFont();
+
+  /**
+   * @brief Get the ResourceCache of the game. It's made on first use, because global UI elements already load their textures before main()
+   *
+   * @return ResourceCache&
+   */
+  ResourceCache& getResources();
   
-  extern sf::RenderWindow* window;
+  // The window, input and sound (see Platform). main() sets it to a window, or to a NullPlatform for a headless run
+  extern Platform* platform;
   extern float unitSize;
 
   extern bool simulationOn;
@@ -28,6 +59,15 @@ namespace Globals {
   // Threads
   extern std::vector<std::thread> threads;
 
+  // Plays the sounds (see AudioEngine). main() starts and stops it
+  extern AudioEngine audio;
+
+  // The cached parts of the level (see SceneLayers). Whatever changes them has to invalidate them
+  extern SceneLayers layers;
+
+  // The sprites, text and shapes of the current frame (see RenderQueue). Flushed once per frame, right before the window is displayed
+  extern RenderQueue renderQueue;
+
   extern bool DEBUG_MODE;
 }
 
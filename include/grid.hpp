@@ -0,0 +1,79 @@
+#ifndef GRID_H_
+#define GRID_H_
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief A uniform grid over the level (one cell per unit) that remembers which colliders are in which cells.
+ * This way the physics only has to check the colliders near the ball instead of all of them.
+ * The grid stores keys, so it doesn't care what a collider is. PhysicsWorld decides what the keys mean.
+ * 
+ */
+class CollisionGrid {
+public:
+
+  /**
+   * @brief Construct a new Collision Grid object
+   * @attention Everything outside of the level is put in the cells at the edge
+   * 
+   * @param newCellSize The size of one cell in pixels (the unit size)
+   * @param levelSize The size of the level in pixels
+   */
+  CollisionGrid(const float newCellSize, const sf::Vector2f levelSize);
+
+  /**
+   * @brief Adds a collider to every cell that its bounding box touches
+   * 
+   * @param key The key of the collider
+   * @param boundsMin The top-left corner of the bounding box
+   * @param boundsMax The bottom-right corner of the bounding box
+   */
+  void insert(const size_t key, const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax);
+
+  /**
+   * @brief Removes a collider. Use the same bounding box as when it was inserted
+   * 
+   * @param key The key of the collider
+   * @param boundsMin The top-left corner of the bounding box
+   * @param boundsMax The bottom-right corner of the bounding box
+   */
+  void remove(const size_t key, const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax);
+
+  /**
+   * @brief Removes all of the colliders
+   * 
+   */
+  void clear();
+
+  /**
+   * @brief Gets the keys of the colliders in the cells that an area touches
+   * 
+   * @param boundsMin The top-left corner of the area
+   * @param boundsMax The bottom-right corner of the area
+   * @param keys Gets filled with the keys, sorted and without duplicates. It is cleared first, so it can be reused without allocating
+   */
+  void query(const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax, std::vector<size_t>& keys);
+
+private:
+
+  /**
+   * @brief Get the range of cells that an area touches
+   * 
+   * @param boundsMin The top-left corner of the area
+   * @param boundsMax The bottom-right corner of the area
+   * @param first Gets set to the top-left cell
+   * @param last Gets set to the bottom-right cell
+   */
+  void getCellRange(const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax, sf::Vector2u& first, sf::Vector2u& last);
+
+  float cellSize;
+  sf::Vector2u gridSize;
+
+  // The cells, row by row
+  std::vector<std::vector<size_t>> cells;
+
+};
+
+#endif // GRID_H_
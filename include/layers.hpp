@@ -0,0 +1,64 @@
+#ifndef LAYERS_H_
+#define LAYERS_H_
+
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// Keeps the parts of the level that hardly ever change in render textures, so a frame only has to copy them to the window
+// instead of drawing every tile, object and money bag again. A layer is only drawn again after something marked it as dirty.
+
+class SceneLayers {
+public:
+
+  enum Layer : uint8_t {
+    BACKGROUND = 0, // The background and the walls. Under the ball
+    FOREGROUND, // The pipes, the placed objects and the money bags that haven't been collected. Over the ball
+    NUM_LAYERS
+  };
+
+  /**
+   * @brief Marks a layer as changed, so it gets drawn again the next time it's used
+   *
+   * @param layer The layer
+   */
+  void invalidate(const Layer layer) {caches[layer].dirty = true;};
+
+  /**
+   * @brief Marks every layer as changed
+   *
+   */
+  void invalidateAll();
+
+  /**
+   * @brief Turns the render textures on or off. When they're off, every layer is drawn straight onto the target every frame
+   *
+   * @param newEnabled Whether the layers are cached
+   */
+  void setEnabled(const bool newEnabled) {enabled = newEnabled;};
+
+  /**
+   * @brief Draws a layer on the target. When the layer is dirty or the size of the target changed, drawContent draws its contents on the layer first
+   *
+   * @param target The target, usually the window
+   * @param layer The layer
+   * @param drawContent Draws the contents of the layer on the target that it gets
+   */
+  void draw(sf::RenderTarget& target, const Layer layer, const std::function<void(sf::RenderTarget&)>& drawContent);
+
+private:
+
+  struct Cache {
+    std::unique_ptr<sf::RenderTexture> texture; // Made when the layer is used for the first time
+    bool dirty = true;
+  };
+
+  std::array<Cache, NUM_LAYERS> caches;
+  bool enabled = true;
+
+};
+
+#endif //LAYERS_H_
@@ -3,7 +3,9 @@
 
 #include "../include/physics.hpp"
 
+#include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
 #include <SFML/System/Vector2.hpp>
 #include <cstdint>
 #include <filesystem>
@@ -11,75 +13,68 @@
 
 #include "../include/ui.hpp"
 #include "../include/dialogue.hpp"
+#include "../include/level_data.hpp"
+#include "../include/render.hpp"
+#include "../include/resources.hpp"
+#include "../include/world.hpp"
 
 class Tilemap {
 public:
 
   /**
-   * @brief Does what the name implies
+   * @brief Set the tiles. The vertices are made again the next time the tilemap is drawn
    * 
-   * @param path The path of the file that needs to be loaded
+   * @param newMap The tiles of the level (see LevelData)
    */
-  void loadFromFile(const std::filesystem::path path);
+  void setMap(const TilemapData& newMap);
 
   /**
-   * @brief Does what the name implies
+   * @brief Does what the name implies. The tiles are only turned into vertices again after the map, the unit size or an atlas changed
    * 
+   * @param target Where to draw it: the window or a scene layer (see SceneLayers)
    * @param walls The wall texture atlas
    * @param props The props texture atlas
    * @param tileSize The size in pixels of a single texture in the atlas
    */
-  void drawPropsWalls(const sf::Texture& walls, const sf::Texture& props, const sf::Vector2i tileSize);
+  void drawPropsWalls(sf::RenderTarget& target, const sf::Texture& walls, const sf::Texture& props, const sf::Vector2i tileSize);
 
   /**
-   * @brief Does what the name implies
+   * @brief Does what the name implies. The tiles are only turned into vertices again after the map, the unit size or the atlas changed
    * 
+   * @param target Where to draw it: the window or a scene layer (see SceneLayers)
    * @param wholeTexture The pipe texture atlas
    * @param tileSize The size in pixels of a single texture in the atlas
    */
-  void drawPipes(const sf::Texture& wholeTexture, const sf::Vector2i tileSize);
+  void drawPipes(sf::RenderTarget& target, const sf::Texture& wholeTexture, const sf::Vector2i tileSize);
 
 private:
 
-  unsigned map[18][18];
-
-};
-
-class BouncyObjects {
-public:
-
-  /**
-   * @brief Generates the walls
-   * 
-   */
-  void makeWalls();
-
-  /**
-   * @brief Generates a new BounyObject
-   * 
-   * @param points The points that make up the shape
-   * @param cor Coefficient of restitution, which is the factor that the speed gets multiplied with upon colision
-   * @param orientation The orientation of the object. This is a vector pointing to the right edge of the object
-   */
-  void makeBO(const std::vector<sf::Vector2f>& points, const float cor, const sf::Vector2f orientation = sf::Vector2f(1,0));
-
-  /**
-   * @brief Loads and generates the BouncyObjects from a level file (*.ql)
-   * 
-   * @param path The path to the level file
-   */
-  void loadFromFile(const std::filesystem::path path);
+  // The tiles of one texture atlas as two triangles each, so the whole layer is drawn with one call
+  struct Layer {
+    sf::VertexArray vertices{sf::PrimitiveType::Triangles};
+    bool built = false;
+    // What the vertices were made for
+    float unitSize = 0;
+    sf::Vector2u textureSize;
+    sf::Vector2i tileSize;
+  };
 
   /**
-   * @brief Get the list of BouncyObjects
+   * @brief Makes the vertices of a layer again if they are out of date
    * 
-   * @return std::vector<PhysicsObjects::BouncyObject>& A reference to the BouncyObjects list
+   * @param layer The layer
+   * @param firstTile The value in the map of the first texture in the atlas
+   * @param numTiles The number of textures in the atlas
+   * @param textureSize The size of the atlas in pixels
+   * @param tileSize The size in pixels of a single texture in the atlas
    */
-  std::vector<PhysicsObjects::BouncyObject>& getList() {return bo_list;};
+  void updateLayer(Layer& layer, const unsigned firstTile, const unsigned numTiles, const sf::Vector2u textureSize, const sf::Vector2i tileSize);
 
-private:
+  TilemapData map{};
 
-  std::vector<PhysicsObjects::BouncyObject> bo_list;
+  Layer wallsLayer;
+  Layer propsLayer;
+  Layer pipesLayer;
 
 };
 
@@ -107,7 +102,7 @@ public:
    * 
    * @param newCollected The new value of collected
    */
-  void setCollected(const bool newCollected) {collected = newCollected;};
+  void setCollected(const bool newCollected);
 
   /**
    * @brief Get the value of collected
@@ -139,8 +134,9 @@ public:
   /**
    * @brief Draws the money bag on the screen
    * 
+   * @param queue The queue that gets the sprite. Where it ends up depends on where the queue is flushed: the window or a scene layer (see SceneLayers)
    */
-  void draw();
+  void draw(RenderQueue& queue);
 
   /**
    * @brief Makes the money bag fall. Stops when it is outside of the screen
@@ -156,7 +152,7 @@ private:
   sf::Vector2f pos;
   uint8_t value;
 
-  sf::Texture texture;
+  SpriteRegion sprite; // All of the money bags share its texture
 
   bool collected;
 
@@ -173,9 +169,10 @@ public:
    * @param _props The texture for the props
    * @param _pipes The texture for the pipes
    * @param _inventory The inventory
+   * @param _world The physics world that holds the level's BouncyObjects and money bags
    */
-  Level(const std::filesystem::path filePath, sf::Texture& _walls, sf::Texture& _props, sf::Texture& _pipes, UIElements::Inventory& _inventory) 
-  : walls(_walls), props(_props), pipes(_pipes), inventory(_inventory), levelFilePath(filePath),
+  Level(const std::filesystem::path filePath, const sf::Texture& _walls, const sf::Texture& _props, const sf::Texture& _pipes, UIElements::Inventory& _inventory, PhysicsWorld& _world) 
+  : walls(_walls), props(_props), pipes(_pipes), inventory(_inventory), world(_world), levelFilePath(filePath),
 	tilemap(), moneyBagsNeeded(0), beginScore(0), neededScore(0) {};
 
   /**
@@ -192,18 +189,18 @@ public:
   void setLevelFilePath(const std::filesystem::path newPath) {levelFilePath = newPath;};
 
   /**
-   * @brief Get the Tilemap object
+   * @brief Get the level file path
    * 
-   * @return Tilemap& A reference to the tilemap
+   * @return std::filesystem::path& The level path (*.ql)
    */
-  Tilemap& getTilemap() {return tilemap;};
+  std::filesystem::path& getLevelFilePath() {return levelFilePath;};
 
   /**
-   * @brief Get the Bouncy Objects object
+   * @brief Get the Tilemap object
    * 
-   * @return BouncyObjects& A reference to the BouncyObjects class
+   * @return Tilemap& A reference to the tilemap
    */
-  BouncyObjects& getBouncyObjects() {return bouncyObjects;};
+  Tilemap& getTilemap() {return tilemap;};
 
   /**
    * @brief Get the money bag vector
@@ -241,27 +238,36 @@ public:
   uint16_t getNeededScore() {return neededScore;};
 
   /**
-   * @brief Initiates the level's tilemap and BouncyObjects
+   * @brief Get the contents of the level file. Empty until initLevel()
+   * 
+   * @return LevelDataHandle
+   */
+  LevelDataHandle getLevelData() {return levelData;};
+
+  /**
+   * @brief Reads the level file, initiates the level's tilemap and loads the level into the physics world
+   * @attention Throws an std::runtime_error if the level file can't be read
    * 
    */
   void initLevel();
 
   /**
-   * @brief Resets the money bags and the score
+   * @brief Resets the money bags and the score. The positions come from the level that initLevel() read, so the file isn't read again
    * 
    */
   void resetMoneyBagPositions();
 
 private:
 
-  sf::Texture& walls;
-  sf::Texture& props;
-  sf::Texture& pipes;
+  const sf::Texture& walls;
+  const sf::Texture& props;
+  const sf::Texture& pipes;
   UIElements::Inventory& inventory;
+  PhysicsWorld& world;
 
   std::filesystem::path levelFilePath;
+  LevelDataHandle levelData;
   Tilemap tilemap;
-  BouncyObjects bouncyObjects;
 
   std::vector<MoneyBag*> moneyBags;
   uint8_t moneyBagsNeeded;
@@ -269,7 +275,7 @@ private:
   UIElements::ScoreLabel scoreLabel;
   UIElements::RunButton runButton;
 
-  sf::Texture runButtonOuter;
+  SpriteRegion runButtonOuter;
 
   uint8_t beginScore = 0;
   uint8_t neededScore = 0;
@@ -0,0 +1,65 @@
+#ifndef LEVEL_DATA_H_
+#define LEVEL_DATA_H_
+
+#include <SFML/System/Vector2.hpp>
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Everything in a level file (*.ql), read in one go. The game, the physics world and the tools all get the level from this,
+// so the file is only read once per level and a failed run resets from memory
+
+// The tilemap is 16 by 16 tiles for the level and 1 on each side for the walls
+const unsigned short TILEMAP_SIZE = 18;
+using TilemapData = std::array<std::array<unsigned, TILEMAP_SIZE>, TILEMAP_SIZE>;
+
+/**
+ * @brief The contents of a level file. The positions are in units, like in the file
+ *
+ */
+struct LevelData {
+  struct InventoryItem {
+    int8_t itemId;
+    int16_t count;
+  };
+
+  // A rectangle from the top-left tile to the bottom-right tile (both included)
+  struct Collider {
+    sf::Vector2f start;
+    sf::Vector2f end;
+    float cor;
+    sf::Vector2f orientation;
+  };
+
+  TilemapData tilemap{}; // Row by row
+  std::vector<InventoryItem> inventory;
+  uint8_t moneyBagsNeeded = 0;
+  std::vector<Collider> colliders; // [BouncyObjects]
+  std::vector<sf::Vector2f> moneyBags; // The midpoints
+};
+
+// The data never changes after it's read, so everyone who needs it can share it
+using LevelDataHandle = std::shared_ptr<const LevelData>;
+
+/**
+ * @brief Reads a level file (*.ql)
+ * @attention Throws an std::runtime_error if the file can't be read or has an invalid line
+ *
+ * @param path The path to the level file
+ * @return LevelDataHandle
+ */
+LevelDataHandle loadLevelData(const std::filesystem::path path);
+
+/**
+ * @brief Parses the text of a level file (*.ql). loadLevelData() uses this
+ * @attention Throws an std::runtime_error if the text has an invalid line
+ *
+ * @param text The contents of the file
+ * @param data Gets filled with the level. The sections that aren't in the text stay like they were
+ */
+void parseLevelData(std::string_view text, LevelData& data);
+
+#endif //LEVEL_DATA_H_
@@ -1,7 +1,92 @@
 #ifndef MATH_H_
 #define MATH_H_
 
-#include <SFML/System.hpp>
+#include <SFML/System/Angle.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cfloat>
+#include <cmath>
+
+// Small vector functions for the collision code. They run for every side of every collider a few times per step,
+// so they are all in this header: the compiler can inline them and vectorize the loops they are in.
+// All of them are in float. Nothing here calls pow or goes through double.
+
+// With SWB_DETERMINISTIC_PHYSICS (the CMake option of the same name) two builds of the physics give exactly the same runs,
+// also with another compiler or on another machine. The build turns off fused multiply-adds and x87 math (see CMakeLists.txt),
+// and rotateVector() doesn't use std::sin and std::cos, because those differ between standard libraries.
+// +, -, *, / and std::sqrt are rounded the same everywhere, so the rest of the physics doesn't have to change.
+// The physics doesn't call sf::Vector2's length(), normalized(), angle() or rotatedBy() either: SFML builds those in sfml-system,
+// which doesn't get these float options. getLength(), getNormalized() and rotateVector() replace them, and the build fails
+// when one of them shows up in the physics library again (see CheckPhysicsMath.cmake)
+#ifdef SWB_DETERMINISTIC_PHYSICS
+static_assert(FLT_EVAL_METHOD == 0, "SWB_DETERMINISTIC_PHYSICS needs floats to be calculated as floats. Use SSE instead of x87 math");
+#endif
+
+/**
+ * @brief Calculates the dot product of two vectors
+ *
+ * @param a Vector A
+ * @param b Vector B
+ * @return constexpr float a.x*b.x + a.y*b.y
+ */
+constexpr float dotProduct(const sf::Vector2f a, const sf::Vector2f b) {
+  return a.x * b.x + a.y * b.y;
+}
+
+/**
+ * @brief Calculates the z of the cross product of two vectors. It is positive when b is counterclockwise from a (in a y-up system)
+ *
+ * @param a Vector A
+ * @param b Vector B
+ * @return constexpr float a.x*b.y - a.y*b.x
+ */
+constexpr float crossProduct(const sf::Vector2f a, const sf::Vector2f b) {
+  return a.x * b.y - a.y * b.x;
+}
+
+/**
+ * @brief Mirrors a vector in a surface, like a ball bouncing off a wall
+ *
+ * @param vector The vector
+ * @param normal The normal of the surface. It doesn't have to have a length of 1, but it can't be (0,0)
+ * @return constexpr sf::Vector2f The vector with the part along the normal flipped
+ */
+constexpr sf::Vector2f reflect(const sf::Vector2f vector, const sf::Vector2f normal) {
+  const float FACTOR = 2.f * dotProduct(vector, normal) / dotProduct(normal, normal);
+  return sf::Vector2f(vector.x - FACTOR * normal.x, vector.y - FACTOR * normal.y);
+}
+
+/**
+ * @brief Calculates the length of a vector, like sf::Vector2::length but inline, so it gets the physics' float options
+ *
+ * @param vector The vector
+ * @return float The length of the vector
+ */
+inline float getLength(const sf::Vector2f vector) {
+  return std::sqrt(dotProduct(vector, vector));
+}
+
+/**
+ * @brief Scales a vector to a length of 1, like sf::Vector2::normalized but inline, so it gets the physics' float options
+ *
+ * @param vector The vector. It can't be (0,0)
+ * @return sf::Vector2f The vector with a length of 1
+ */
+inline sf::Vector2f getNormalized(const sf::Vector2f vector) {
+  return vector / getLength(vector);
+}
+
+/**
+ * @brief Calculates the squared distance from a point to another point. Compare it with a squared radius to skip the square root
+ *
+ * @param a Point A
+ * @param b Point B
+ * @return constexpr float The squared distance between the two points
+ */
+constexpr float getDistanceSq(const sf::Vector2f a, const sf::Vector2f b) {
+  const float DX = a.x - b.x;
+  const float DY = a.y - b.y;
+  return DX * DX + DY * DY;
+}
 
 /**
  * @brief Calculates the distance from a point to another point
@@ -11,7 +96,22 @@
  *
  * @return The distance between the two points
  */
-float getDistance(const sf::Vector2f a, const sf::Vector2f b);
+inline float getDistance(const sf::Vector2f a, const sf::Vector2f b) {
+  return std::sqrt(getDistanceSq(a, b));
+}
+
+/**
+ * @brief Calculates the signed distance from a point to a line of which (a,b) has a length of 1, like the sides of a BouncyObject
+ *
+ * @param a a from ax+by+c=0
+ * @param b b from ax+by+c=0
+ * @param c c from ax+by+c=0
+ * @param point The point
+ * @return constexpr float The distance, positive on the side that (a,b) points to
+ */
+constexpr float getSignedDistance(const float a, const float b, const float c, const sf::Vector2f point) {
+  return a * point.x + b * point.y + c;
+}
 
 /**
  * @brief Caclucates the distance from a point to a line
@@ -23,6 +123,50 @@ float getDistance(const sf::Vector2f a, const sf::Vector2f b);
  *
  * @return float Distance between the point and the line
  */
-float getDistance(const float a, const float b, const float c, const sf::Vector2f point);
+inline float getDistance(const float a, const float b, const float c, const sf::Vector2f point) {
+  return std::abs(getSignedDistance(a, b, c, point)) / std::sqrt(a * a + b * b);
+}
+
+/**
+ * @brief Calculates the sine and cosine of an angle with only +, -, * and /, so the result is the same with every compiler and standard library
+ *
+ * @param degrees The angle in degrees
+ * @param sine Gets the sine
+ * @param cosine Gets the cosine
+ */
+inline void getSinCos(const float degrees, float& sine, float& cosine) {
+  // Bring the angle to [-45, 45] degrees. The polynomials below are accurate to a float there
+  const float QUADRANT = std::round(degrees / 90.f);
+  const float X = (degrees - QUADRANT * 90.f) * (3.14159265f / 180.f);
+  const float X2 = X * X;
+
+  const float SINE = X * (1.f + X2 * (-1.f / 6.f + X2 * (1.f / 120.f + X2 * (-1.f / 5040.f + X2 * (1.f / 362880.f)))));
+  const float COSINE = 1.f + X2 * (-1.f / 2.f + X2 * (1.f / 24.f + X2 * (-1.f / 720.f + X2 * (1.f / 40320.f + X2 * (-1.f / 3628800.f)))));
+
+  // Turn the result back by the quarter turns that were taken off
+  switch (static_cast<int>(std::fmod(QUADRANT, 4.f) + 4.f) % 4) {
+    case 0: sine = SINE; cosine = COSINE; break;
+    case 1: sine = COSINE; cosine = -SINE; break;
+    case 2: sine = -SINE; cosine = -COSINE; break;
+    default: sine = -COSINE; cosine = SINE; break;
+  }
+}
+
+/**
+ * @brief Rotates a vector like sf::Vector2::rotatedBy. Use this in the physics, so a SWB_DETERMINISTIC_PHYSICS build rotates the same way everywhere
+ *
+ * @param vector The vector
+ * @param degrees The angle in degrees, clockwise in SFML coordinates (y down)
+ * @return sf::Vector2f The rotated vector
+ */
+inline sf::Vector2f rotateVector(const sf::Vector2f vector, const float degrees) {
+#ifdef SWB_DETERMINISTIC_PHYSICS
+  float sine, cosine;
+  getSinCos(degrees, sine, cosine);
+  return sf::Vector2f(vector.x * cosine - vector.y * sine, vector.x * sine + vector.y * cosine);
+#else
+  return vector.rotatedBy(sf::degrees(degrees));
+#endif
+}
 
-#endif //MATH_H_
\ No newline at end of file
+#endif //MATH_H_
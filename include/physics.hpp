@@ -1,26 +1,51 @@
 #ifndef PHYSICS_H_
 #define PHYSICS_H_
 
-#include <SFML/Graphics/Sprite.hpp>
-#include <SFML/Graphics/Texture.hpp>
 #include <SFML/System/Vector2.hpp>
-#include <vector>
+#include <array>
+
+#include "../include/math.hpp"
+
+// Everything in this file is part of the headless physics library (SorryWereBroke_physics).
+// Keep it free of windows, textures and audio.
 
 namespace PhysicsObjects {
+
+  // Every collider is a quadrilateral
+  const unsigned short NUM_SIDES = 4;
+  using Points = std::array<sf::Vector2f, NUM_SIDES>;
+
+  /**
+   * @brief Gets the corners of a rotated rectangle, like sf::RectangleShape would do with its origin in the middle
+   * 
+   * @param center The center of the rectangle
+   * @param size The size of the rectangle in pixels
+   * @param rotation The rotation in degrees (clockwise, like SFML)
+   * @return Points The points in the order top-right, bottom-right, bottom-left, top-left (before rotating)
+   */
+  Points getRectanglePoints(const sf::Vector2f& center, const sf::Vector2f& size, const float rotation);
+
+  /**
+   * @brief Get the direction of a velocity vector
+   * 
+   * @param velocity The velocity vector
+   * @return sf::Vector2f The velocity normalized, or (0,0) if the velocity is 0
+   */
+  sf::Vector2f getDirection(const sf::Vector2f& velocity);
   
-  class Ball : public sf::Sprite {
+  class Ball {
 
   public:
 
     /**
      * @brief Construct a new Ball object
+     * @attention The ball has no sprite anymore. The game draws its own sprite at getMidpoint()
      * 
-     * @param texture The texture for the ball
      * @param mid Midpoint
      * @param m Mass
      * @param r Radius
      */
-    Ball(const sf::Texture& texture, const sf::Vector2f mid, const float m = 1, const float r = 50);
+    Ball(const sf::Vector2f mid, const float m = 1, const float r = 50);
     
     /**
      * @brief Set the mass
@@ -62,7 +87,14 @@ namespace PhysicsObjects {
      * 
      * @return float The velocity (length of the velocityVector).
      */
-    float getVelocity() {return velocityVector.length();};
+    float getVelocity() {return getLength(velocityVector);};
+
+    /**
+     * @brief Get the velocity vector
+     * 
+     * @return sf::Vector2f& A reference to the velocity vector (physics coordinates, so y points up)
+     */
+    sf::Vector2f& getVelocityVector() {return velocityVector;};
     
     /**
      * @brief Get the direction
@@ -76,7 +108,7 @@ namespace PhysicsObjects {
      * 
      * @param newRadius The new radius
      */
-    void setRadius(const float newRadius);
+    void setRadius(const float newRadius) {radius = newRadius;};
 
     /**
      * @brief Get the radius
@@ -112,23 +144,60 @@ namespace PhysicsObjects {
 
   };
 
+  /**
+   * @brief A side of a BouncyObject. setPoints() calculates these once, so the collision checks only have to read them
+   * 
+   */
+  struct Edge {
+    // The line ax+by+c=0. (a,b) is the unit normal that checkBallCollision() has always used, so |ax+by+c| is the distance to the line
+    float a, b, c;
+    sf::Vector2f outwardNormal; // The unit normal that points away from the shape
+    sf::Vector2f start; // The first point of the side
+    sf::Vector2f direction; // The unit vector from the first to the second point
+    float length;
+    // If xDirection is true, the side is more horizontal than vertical. low and high are the smallest and biggest x (or y) of the side
+    bool xDirection;
+    float low, high;
+  };
+
   class BouncyObject {
   
   public:
 
     /**
-     * @brief Set the points
+     * @brief Set the points and calculate the edges and the bounding box
      * 
      * @param newPoints The new points
      */
-    void setPoints(const std::vector<sf::Vector2f>& newPoints) {points = newPoints;};
+    void setPoints(const Points& newPoints);
 
     /**
      * @brief Get the points
      * 
-     * @return std::vector<sf::Vector2f>& A reference to the list of points
+     * @return const Points& A reference to the list of points
      */
-    std::vector<sf::Vector2f>& getPoints() {return points;};
+    const Points& getPoints() {return points;};
+
+    /**
+     * @brief Get the precomputed sides
+     * 
+     * @return const std::array<Edge, NUM_SIDES>& A reference to the sides
+     */
+    const std::array<Edge, NUM_SIDES>& getEdges() {return edges;};
+
+    /**
+     * @brief Get the top-left corner of the bounding box
+     * 
+     * @return const sf::Vector2f& 
+     */
+    const sf::Vector2f& getBoundsMin() {return boundsMin;};
+
+    /**
+     * @brief Get the bottom-right corner of the bounding box
+     * 
+     * @return const sf::Vector2f& 
+     */
+    const sf::Vector2f& getBoundsMax() {return boundsMax;};
 
     /**
      * @brief Set the orientation
@@ -166,6 +235,38 @@ namespace PhysicsObjects {
      */
     int checkBallCollision(Ball& ball);
 
+    /**
+     * @brief Same as checkBallCollision, but for a ball that isn't a Ball object (see BallBatch)
+     * 
+     * @param midpoint The midpoint of the ball
+     * @param radius The radius of the ball
+     * @param direction The direction in which the ball moves (see PhysicsObjects::getDirection)
+     * @return int The (most likely) side on which the ball collides
+     */
+    int checkCircleCollision(const sf::Vector2f& midpoint, const float radius, const sf::Vector2f& direction);
+
+    /**
+     * @brief Sweeps the ball along its movement of this step and finds the earliest moment it touches this shape (continuous collision detection)
+     * @attention Only contacts where the ball moves towards the shape count, so a ball that just bounced off is not hit again
+     * 
+     * @param ball A reference to the ball
+     * @param displacement How much the midpoint of the ball moves during the step (in SFML coordinates, so y points down)
+     * @param timeOfImpact Gets set to the part [0,1] of the displacement after which the ball touches the shape
+     * @return int The side that the ball hits first. -1 if the ball doesn't hit the shape during this step
+     */
+    int sweepBallCollision(Ball& ball, const sf::Vector2f& displacement, float& timeOfImpact);
+
+    /**
+     * @brief Same as sweepBallCollision, but for a ball that isn't a Ball object (see BallBatch)
+     * 
+     * @param start The midpoint of the ball at the start of the step
+     * @param radius The radius of the ball
+     * @param displacement How much the midpoint of the ball moves during the step (in SFML coordinates, so y points down)
+     * @param timeOfImpact Gets set to the part [0,1] of the displacement after which the ball touches the shape
+     * @return int The side that the ball hits first. -1 if the ball doesn't hit the shape during this step
+     */
+    int sweepCircleCollision(const sf::Vector2f& start, const float radius, const sf::Vector2f& displacement, float& timeOfImpact);
+
     /**
      * @brief Bounces the ball. It calcuates the needed force based on the COR of the surface and appies it
      * 
@@ -174,6 +275,15 @@ namespace PhysicsObjects {
      */
     void bounce(Ball& ball, const short side);
 
+    /**
+     * @brief Get the velocity after a bounce, without changing anything. bounce() uses this too
+     * 
+     * @param velocity The velocity vector of the ball before the bounce (physics coordinates, so y points up)
+     * @param side The side to bounce the ball of
+     * @return sf::Vector2f The velocity vector after the bounce
+     */
+    sf::Vector2f getBouncedVelocity(const sf::Vector2f& velocity, const short side);
+
     /**
      * @brief Set justBounced
      * 
@@ -192,7 +302,13 @@ namespace PhysicsObjects {
 
     // The points are in the following order:
     // top-left, top-right, bottom-left, bottom-right
-    std::vector<sf::Vector2f> points;
+    Points points;
+
+    // Everything below is calculated from the points by setPoints()
+    std::array<Edge, NUM_SIDES> edges{};
+    sf::Vector2f center;
+    sf::Vector2f boundsMin;
+    sf::Vector2f boundsMax;
 
     sf::Vector2f orientation = {1, 0};
     float cor = 0.8f; // Coefficient of restitution. This is the factor with which the ball gets slowed down upon impact.
@@ -201,6 +317,18 @@ namespace PhysicsObjects {
 
   };
 
+  /**
+   * @brief Makes the BouncyObject of a bounce pad, the same way for the game, the solver and the replays
+   * 
+   * @param pos The position of the middle in pixels
+   * @param size The size in units
+   * @param rotation The rotation in degrees
+   * @param unitSize The conversion factor from units to pixels
+   * @param cor The coefficient of restitution
+   * @return BouncyObject 
+   */
+  BouncyObject makeBouncePad(const sf::Vector2i& pos, const sf::Vector2f& size, const float rotation, const float unitSize, const float cor = 0.95f);
+
   class Booster : public BouncyObject {
   public:
 
@@ -215,18 +343,29 @@ namespace PhysicsObjects {
      * @brief Construct a new Booster object
      * 
      * @param newPos The position
-     * @param newSize The size
+     * @param newSize The size in units
      * @param newRotation The rotation
+     * @param unitSize The conversion factor from units to pixels
      * @param boostExtra The part of the speed of the ball that is added when the ball collides
      */
-    Booster(const sf::Vector2i& newPos, const sf::Vector2f& newSize, const float newRotation, const float boostExtra = 0.5f);
+    Booster(const sf::Vector2i& newPos, const sf::Vector2f& newSize, const float newRotation, const float unitSize, const float boostExtra = 0.5f);
 
     /**
      * @brief Increases the velocity of the ball based on its velocity direction and the boostFactor 
+     * @attention This doesn't play a sound. Use the return value to pick one.
      * 
      * @param ball The ball
+     * @return true if the ball got faster, false if it slowed down
+     */
+    bool boost(Ball& ball);
+
+    /**
+     * @brief Get the velocity after a boost, without changing anything. boost() uses this too
+     * 
+     * @param velocity The velocity vector of the ball before the boost (physics coordinates, so y points up)
+     * @return sf::Vector2f The velocity vector after the boost
      */
-    void boost(Ball& ball);
+    sf::Vector2f getBoostedVelocity(const sf::Vector2f& velocity);
 
     /**
      * @brief Set the value of justBoosted. This prevents the ball from being repeatedly boosted when it collides
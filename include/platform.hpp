@@ -0,0 +1,234 @@
+#ifndef PLATFORM_H_
+#define PLATFORM_H_
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Window/Event.hpp>
+#include <SFML/Window/Keyboard.hpp>
+#include <atomic>
+#include <cstddef>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../include/config.hpp"
+#include "../include/resources.hpp"
+
+// Everything the game needs from the machine it runs on: somewhere to draw, the input and the sound.
+// SfmlPlatform is the normal window. NullPlatform has no window: it throws the pixels away, plays the input from a script (*.qi)
+// and drops the sounds, so the whole game can run on a build server without a screen (see Globals::platform)
+
+class Platform {
+public:
+
+  virtual ~Platform() = default;
+
+  /**
+   * @brief Get the target that the frame is drawn on
+   *
+   * @return sf::RenderTarget&
+   */
+  virtual sf::RenderTarget& getTarget() = 0;
+
+  /**
+   * @brief Get the size of the window in pixels
+   *
+   * @return sf::Vector2u
+   */
+  virtual sf::Vector2u getSize() const = 0;
+
+  /**
+   * @brief Whether the window is still open. The game stops when it isn't
+   *
+   * @return bool
+   */
+  virtual bool isOpen() const = 0;
+
+  /**
+   * @brief Closes the window
+   *
+   */
+  virtual void close() = 0;
+
+  /**
+   * @brief Takes the next input event
+   *
+   * @param event Gets the event
+   * @return true if there was one
+   */
+  virtual bool pollEvent(sf::Event& event) = 0;
+
+  /**
+   * @brief Get the position of the mouse relative to the window
+   *
+   * @return sf::Vector2i
+   */
+  virtual sf::Vector2i getMousePosition() const = 0;
+
+  /**
+   * @brief Whether a key is held down
+   *
+   * @param key The key
+   * @return bool
+   */
+  virtual bool isKeyPressed(const sf::Keyboard::Scan key) const = 0;
+
+  /**
+   * @brief Clears the frame
+   *
+   * @param color The colour to clear it with
+   */
+  virtual void clear(const sf::Color color = sf::Color::Black) = 0;
+
+  /**
+   * @brief Shows the frame and ends it
+   *
+   */
+  virtual void display() = 0;
+
+  /**
+   * @brief Plays a sound
+   *
+   * @param buffer The sound
+   * @return true if the sound was queued
+   */
+  virtual bool playSound(const SoundBufferHandle& buffer) = 0;
+
+  /**
+   * @brief Whether there's no window. Nothing that is drawn is ever seen then
+   *
+   * @return bool
+   */
+  virtual bool isHeadless() const = 0;
+
+};
+
+/**
+ * @brief The game in a normal SFML window, with the sounds played by Globals::audio
+ *
+ */
+class SfmlPlatform : public Platform {
+public:
+
+  /**
+   * @brief Construct a new Sfml Platform object. Opens the window
+   *
+   * @param size The size of the window in pixels. The window can't be resized
+   * @param title The title of the window
+   */
+  SfmlPlatform(const sf::Vector2u size, const std::string& title);
+
+  sf::RenderTarget& getTarget() override {return window;};
+  sf::Vector2u getSize() const override {return window.getSize();};
+  bool isOpen() const override {return window.isOpen();};
+  void close() override {window.close();};
+  bool pollEvent(sf::Event& event) override {return window.pollEvent(event);};
+  sf::Vector2i getMousePosition() const override;
+  bool isKeyPressed(const sf::Keyboard::Scan key) const override;
+  void clear(const sf::Color color = sf::Color::Black) override {window.clear(color);};
+  void display() override {window.display();};
+  bool playSound(const SoundBufferHandle& buffer) override;
+  bool isHeadless() const override {return false;};
+
+private:
+
+  sf::RenderWindow window;
+
+};
+
+/**
+ * @brief The game without a window, for measuring the frame times on a build server.
+ * Nothing reaches the GPU: every draw is counted and thrown away. The input comes from a script and the sounds are dropped.
+ * @attention The textures and the fonts still need an OpenGL context to load. On a machine without a display,
+ * run the game in a virtual one (like xvfb-run) with a software renderer
+ *
+ */
+class NullPlatform : public Platform {
+public:
+
+  /**
+   * @brief Construct a new Null Platform object
+   *
+   * @param size The size that the window would have
+   */
+  NullPlatform(const sf::Vector2u size) : target(size) {};
+
+  /**
+   * @brief Loads the input script (*.qi). Every line is a frame number and a command:
+   * MOVE X Y, CLICK X Y (moves the mouse and clicks the left button), PRESS KEYBIND, RELEASE KEYBIND or CLOSE.
+   * The game closes after the last command
+   * @attention Throws an std::runtime_error if the script can't be read
+   *
+   * @param path The path to the script
+   * @param config The config that has the keybinds that PRESS and RELEASE use
+   */
+  void loadScript(const std::filesystem::path& path, Config& config);
+
+  sf::RenderTarget& getTarget() override {return target;};
+  sf::Vector2u getSize() const override {return target.getSize();};
+  bool isOpen() const override {return open;};
+  void close() override {open = false;};
+  bool pollEvent(sf::Event& event) override;
+  sf::Vector2i getMousePosition() const override {return mousePosition;};
+  bool isKeyPressed(const sf::Keyboard::Scan key) const override {return pressedKeys.count(key) > 0;};
+  void clear(const sf::Color) override {};
+  void display() override;
+  bool playSound(const SoundBufferHandle&) override {++soundsDropped; return true;};
+  bool isHeadless() const override {return true;};
+
+  /**
+   * @brief Get the number of frames that were displayed
+   *
+   * @return size_t
+   */
+  size_t getFrame() const {return frame;};
+
+  /**
+   * @brief Get the number of draws that would have gone to the GPU
+   *
+   * @return size_t
+   */
+  size_t getDrawCalls() const {return target.drawCalls;};
+
+  /**
+   * @brief Get the number of sounds that would have been played
+   *
+   * @return size_t
+   */
+  size_t getSoundsDropped() const {return soundsDropped;};
+
+private:
+
+  // A render target without an OpenGL context. SFML asks for the context before every draw and skips the draw when it doesn't get it
+  class NullTarget : public sf::RenderTarget {
+  public:
+    NullTarget(const sf::Vector2u newSize) : size(newSize) {initialize();};
+    sf::Vector2u getSize() const override {return size;};
+    bool setActive(bool active = true) override {if (active) ++drawCalls; return false;};
+
+    sf::Vector2u size;
+    size_t drawCalls = 0;
+  };
+
+  struct ScriptedEvent {
+    size_t frame;
+    sf::Event event;
+  };
+
+  NullTarget target;
+  bool open = true;
+
+  std::vector<ScriptedEvent> script;
+  size_t nextEvent = 0;
+  size_t frame = 0;
+
+  sf::Vector2i mousePosition;
+  std::set<sf::Keyboard::Scan> pressedKeys;
+  std::atomic<size_t> soundsDropped{0}; // The dialogue plays its sounds from its own thread
+
+};
+
+#endif //PLATFORM_H_
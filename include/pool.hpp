@@ -0,0 +1,127 @@
+#ifndef POOL_H_
+#define POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief A thread pool where every worker has its own queue of tasks.
+ * A worker takes the newest task from its own queue (so a search goes depth-first and stays in the cache)
+ * and when that is empty, it steals the oldest task from another worker (which is usually the biggest piece of work left).
+ * 
+ */
+class WorkStealingPool {
+public:
+
+  /**
+   * @brief A task gets the index of the worker that runs it, so it can use per-worker data
+   * 
+   */
+  using Task = std::function<void(const size_t worker)>;
+
+  /**
+   * @brief Construct a new Work Stealing Pool object and start the workers
+   * 
+   * @param numThreads The number of workers. 0 means one per hardware thread
+   */
+  WorkStealingPool(unsigned int numThreads = 0);
+
+  /**
+   * @brief Cancels the remaining tasks and stops the workers
+   * 
+   */
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  /**
+   * @brief Adds a task. From inside a task, it goes to the queue of the worker that runs it. From outside, the tasks get spread over the workers
+   * 
+   * @param task The task
+   */
+  void push(Task task);
+
+  /**
+   * @brief Blocks until every task (including the ones that tasks pushed) is done
+   * @attention Throws the first exception that a task threw. The tasks that were still queued then were thrown away
+   * 
+   */
+  void wait();
+
+  /**
+   * @brief Throws away the tasks that haven't started yet. Running tasks still finish
+   * 
+   */
+  void cancel();
+
+  /**
+   * @brief Get the number of workers
+   * 
+   * @return size_t 
+   */
+  size_t size() {return workers.size();};
+
+  /**
+   * @brief Get the number of tasks that were stolen from another worker
+   * 
+   * @return size_t 
+   */
+  size_t getSteals() {return steals;};
+
+private:
+
+  struct Worker {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  /**
+   * @brief The loop of a worker
+   * 
+   * @param index The index of the worker
+   */
+  void run(const size_t index);
+
+  /**
+   * @brief Finds a task for a worker, first in its own queue and then in the others
+   * 
+   * @param index The index of the worker
+   * @param task Gets set to the task
+   * @return true if a task was found
+   */
+  bool findTask(const size_t index, Task& task);
+
+  /**
+   * @brief Marks a task as done and wakes up wait() when it was the last one
+   * 
+   */
+  void finishTask();
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::thread> threads;
+
+  std::atomic<size_t> pending{0}; // Tasks that are queued or running
+  std::atomic<size_t> nextWorker{0}; // For spreading the tasks that are pushed from outside
+  std::atomic<size_t> steals{0};
+  std::atomic<bool> stopping{false};
+
+  // The first exception of a task, for wait()
+  std::mutex errorMutex;
+  std::exception_ptr error;
+
+  std::mutex sleepMutex;
+  std::condition_variable workAvailable;
+  std::condition_variable allDone;
+
+};
+
+#endif // POOL_H_
@@ -0,0 +1,89 @@
+#ifndef PREVIEW_H_
+#define PREVIEW_H_
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "../include/trajectory.hpp"
+#include "../include/world.hpp"
+
+// Predicts the path of the ball with an item that isn't placed yet, a few ticks per frame.
+// The game draws it while the player moves a GhostObject around.
+// When only the item moves, the prediction continues from the last checkpoint before the ball came near its old or new place (see TrajectoryCache).
+
+class TrajectoryPreview {
+public:
+
+  // The prediction stops after this many ticks (20 seconds), even if the ball is still moving.
+  // It moves in the same ticks as the game (see PhysicsWorld::tick), so it shows the path that the ball really takes
+  static const unsigned short MAX_TICKS = 2400;
+
+  /**
+   * @brief Starts a new prediction if the world (see PhysicsWorld::getRevision) has changed since the last one.
+   * If only the item has changed, it goes back to the part of the prediction that the item can't have changed
+   *
+   * @param world The world with the level and the items that are already placed. It gets copied, not changed
+   * @param newItem The item that is being placed. Items that don't have physics are left out
+   */
+  void update(PhysicsWorld& world, const Placement& newItem);
+
+  /**
+   * @brief Continues the prediction for at most a number of ticks
+   *
+   * @param maxTicks The budget for this call
+   * @return size_t The number of ticks that were taken
+   */
+  size_t advance(const size_t maxTicks);
+
+  /**
+   * @brief Returns whether the prediction has reached the end of the run (or MAX_TICKS)
+   *
+   */
+  bool isDone() {return done;};
+
+  /**
+   * @brief Get the positions of the ball so far, starting at its origin
+   *
+   * @return std::vector<sf::Vector2f>&
+   */
+  const std::vector<sf::Vector2f>& getPoints() {return trajectory.getPoints();};
+
+  /**
+   * @brief Forgets the prediction, so the next update() starts a new one
+   *
+   */
+  void clear();
+
+private:
+
+  /**
+   * @brief Adds the item to the copy of the world, if it has physics
+   *
+   * @param boundsMin Gets extended with the top-left corner of the item
+   * @param boundsMax Gets extended with the bottom-right corner of the item
+   */
+  void addItem(sf::Vector2f& boundsMin, sf::Vector2f& boundsMax);
+
+  /**
+   * @brief Removes the item from the copy of the world, if it is in there
+   *
+   * @param boundsMin Gets extended with the top-left corner of the item
+   * @param boundsMax Gets extended with the bottom-right corner of the item
+   */
+  void removeItem(sf::Vector2f& boundsMin, sf::Vector2f& boundsMax);
+
+  // A copy of the game's world with the item in it. Only made while the player is placing something
+  std::unique_ptr<PhysicsWorld> world;
+  Placement item{-1, sf::Vector2i(), 0.f};
+  bool hasItemId = false;
+  size_t itemId = 0; // The ID of the item in the copy of the world
+  size_t worldRevision = 0;
+
+  TrajectoryCache trajectory;
+  bool done = true;
+
+};
+
+#endif //PREVIEW_H_
@@ -0,0 +1,168 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Times the stages of a frame. PROFILE_SCOPE("name") at the top of a block records when the block starts and ends.
+// Every thread writes into its own ring buffer without a lock, and writeTrace() saves the buffers as a Chrome trace
+// (open it in chrome://tracing or ui.perfetto.dev). When a frame takes longer than the budget, the last seconds are saved automatically.
+// It's off until setEnabled(true), so the tools don't pay for it. It doesn't need SFML, so the physics library uses it too
+
+class Profiler {
+public:
+
+  // The number of scopes that every thread keeps. Has to be a power of 2. At 60 fps and a few dozen physics steps per frame,
+  // that's still more than HITCH_HISTORY_NS. A skipped run can fill it with physics steps on its own
+  static constexpr size_t BUFFER_SIZE = 1 << 15;
+  // How much a hitch dump goes back
+  static constexpr int64_t HITCH_HISTORY_NS = 3'000'000'000;
+  // A game doesn't save more hitch dumps than this, so a slow machine doesn't fill the disk
+  static constexpr unsigned MAX_HITCH_DUMPS = 10;
+
+  /**
+   * @brief Get the profiler of the program
+   *
+   * @return Profiler&
+   */
+  static Profiler& get();
+
+  /**
+   * @brief Get the current time in nanoseconds. Only the difference between two times means something
+   *
+   * @return int64_t
+   */
+  static int64_t now();
+
+  /**
+   * @brief Turns the recording on or off
+   *
+   * @param newEnabled Whether scopes are recorded
+   */
+  void setEnabled(const bool newEnabled) {enabled.store(newEnabled, std::memory_order_relaxed);};
+
+  /**
+   * @brief Whether scopes are recorded
+   *
+   * @return bool
+   */
+  bool isEnabled() const {return enabled.load(std::memory_order_relaxed);};
+
+  /**
+   * @brief Names the thread that calls this in the trace
+   *
+   * @param name The name
+   */
+  void setThreadName(const std::string& name);
+
+  /**
+   * @brief Adds a scope to the buffer of the thread that calls this. Use PROFILE_SCOPE instead
+   *
+   * @param name The name of the scope. Has to live as long as the program, like a string literal
+   * @param start The time the scope started (see now())
+   * @param end The time the scope ended
+   */
+  void record(const char* name, const int64_t start, const int64_t end);
+
+  /**
+   * @brief Saves the scopes that are in the buffers as a Chrome trace (JSON). Can be called while other threads are recording
+   * @attention Throws an std::runtime_error if the file can't be written
+   *
+   * @param path The path of the trace
+   * @param since Only the scopes that ended at or after this time (see now()) are saved
+   */
+  void writeTrace(const std::filesystem::path& path, const int64_t since = INT64_MIN);
+
+  /**
+   * @brief Sets up the hitch recorder: when a frame takes longer than the budget, endFrame() saves the last HITCH_HISTORY_NS
+   *
+   * @param budgetMs The longest a frame can take in milliseconds. 0 turns the recorder off
+   * @param directory Where the dumps go (hitch0.json, hitch1.json and so on)
+   */
+  void setHitchBudget(const float budgetMs, const std::filesystem::path& directory);
+
+  /**
+   * @brief Marks the end of a frame and checks if it was a hitch. Only call this from the thread that runs the frames
+   *
+   */
+  void endFrame();
+
+private:
+
+  Profiler() = default;
+
+  // The fields are atomics, so writeTrace() can read a slot while its thread overwrites it. It throws such a slot away
+  struct Slot {
+    std::atomic<const char*> name{nullptr};
+    std::atomic<int64_t> start{0};
+    std::atomic<int64_t> end{0};
+  };
+
+  // Only its own thread writes to it. started goes up before a slot is written and written after, so a reader can tell which slots it can trust
+  struct ThreadBuffer {
+    std::array<Slot, BUFFER_SIZE> slots;
+    std::atomic<uint64_t> started{0};
+    std::atomic<uint64_t> written{0};
+    size_t id;
+    std::string name; // Guarded by mutex
+  };
+
+  /**
+   * @brief Get the buffer of the thread that calls this. Made the first time
+   *
+   * @return ThreadBuffer&
+   */
+  ThreadBuffer& getThreadBuffer();
+
+  std::atomic<bool> enabled{false};
+
+  // Only guards the list of buffers and their names. Recording doesn't need it
+  std::mutex mutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers; // Kept until the program ends, so a thread that stopped can still be in the trace
+
+  // The hitch recorder. Only used by the thread that calls endFrame()
+  int64_t hitchBudget = 0;
+  std::filesystem::path hitchDirectory;
+  int64_t lastFrameEnd = 0;
+  int64_t lastHitchDump = 0;
+  unsigned hitchDumps = 0;
+
+};
+
+/**
+ * @brief Records the time between its construction and destruction. Use PROFILE_SCOPE
+ *
+ */
+class ProfileScope {
+public:
+
+  ProfileScope(const char* newName) : name(newName), active(Profiler::get().isEnabled()), start(active ? Profiler::now() : 0) {};
+
+  ~ProfileScope() {
+    if (active) Profiler::get().record(name, start, Profiler::now());
+  }
+
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+
+  const char* name;
+  bool active;
+  int64_t start;
+
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+// Records the rest of the block as a scope with this name (a string literal)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+
+#endif //PROFILER_H_
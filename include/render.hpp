@@ -0,0 +1,101 @@
+#ifndef RENDER_H_
+#define RENDER_H_
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../include/resources.hpp"
+
+// Collects the sprites of a frame instead of drawing them one by one. flush() sorts them by layer and draws every run
+// of sprites in a row with the same texture as one vertex array, so a frame takes a few draw calls instead of one per sprite.
+// It doesn't sort by texture: sprites that overlap have to stay in the order they were submitted in, so only neighbours get merged.
+// Most sprites come from the sprite atlas, so the runs are long anyway. A text or a shape between two sprites ends a run
+
+class RenderQueue {
+public:
+
+  // Everything in a layer is drawn over everything in the layers before it. Within a layer, the sprites and the other drawables
+  // (text, shapes) are drawn in the order they were submitted in
+  enum Layer : uint8_t {
+    WORLD = 0, // Things in the level that move: the falling money bags and the object that is being placed
+    UI, // Buttons, labels and their text
+    UI_ICONS, // Things on top of the buttons, like the items in the inventory
+    POPUP, // The dialogue and the help texts. Over all of the other UI
+    NUM_LAYERS
+  };
+
+  /**
+   * @brief Adds a sprite
+   *
+   * @param layer The layer
+   * @param sprite The texture and the part of it to draw. The queue holds the texture until the flush
+   * @param transform The transform of the sprite, like sf::Sprite::getTransform()
+   * @param color The colour the sprite gets multiplied with
+   */
+  void submit(const Layer layer, const SpriteRegion& sprite, const sf::Transform& transform, const sf::Color color = sf::Color::White);
+
+  /**
+   * @brief Adds something that can't be merged with the sprites, like text or a shape. It's copied, so it doesn't have to live until the flush
+   *
+   * @tparam T The type of the drawable
+   * @param layer The layer
+   * @param drawable The drawable
+   */
+  template <typename T>
+  void submit(const Layer layer, const T& drawable) {
+    commands.push_back({layer, true, nullptr, drawables.size()});
+    drawables.push_back(std::make_unique<T>(drawable));
+  }
+
+  /**
+   * @brief Draws everything that was submitted since the last flush, and empties the queue
+   *
+   * @param target The target, usually the window
+   */
+  void flush(sf::RenderTarget& target);
+
+  /**
+   * @brief Get the number of draw calls of the last flush
+   *
+   * @return size_t
+   */
+  size_t getDrawCalls() const {return drawCalls;};
+
+private:
+
+  struct Quad {
+    TextureHandle texture;
+    sf::Vector2f size;
+    sf::FloatRect textureRect;
+    sf::Transform transform;
+    sf::Color color;
+  };
+
+  struct Command {
+    Layer layer;
+    bool isDrawable;
+    const sf::Texture* texture; // Only for quads
+    size_t index; // In quads or drawables
+  };
+
+  std::vector<Command> commands;
+  std::vector<Quad> quads;
+  std::vector<std::unique_ptr<sf::Drawable>> drawables;
+
+  // Kept between flushes, so the batches don't allocate every frame
+  sf::VertexArray batch{sf::PrimitiveType::Triangles};
+  size_t drawCalls = 0;
+
+};
+
+#endif //RENDER_H_
@@ -0,0 +1,164 @@
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../include/world.hpp"
+
+// A recorded run: the level (the whole text of its file), the placed items and the exact time steps the world was stepped with.
+// Playing it back gives the same run bit for bit, no matter the frame rate of the machine it runs on.
+
+/**
+ * @brief How a run ended
+ *
+ */
+struct ReplayResult {
+  uint32_t steps = 0;
+  sf::Vector2f ballEnd;
+  uint16_t collectedValue = 0;
+  std::vector<bool> collectedBags; // In the order of [MoneyBags] in the level file
+};
+
+class Replay {
+public:
+
+  /**
+   * @brief Starts a recording. Call this before the first step of the run
+   * @attention Throws an std::runtime_error if the level file can't be read
+   *
+   * @param newLevelPath The path to the level file (*.ql) that the world has loaded. The replay keeps a copy of its text
+   * @param world The world. Its ball must still be at the origin
+   * @param newPlacements The items that the player placed, in the order they were added to the world
+   */
+  void start(const std::filesystem::path newLevelPath, PhysicsWorld& world, const std::vector<Placement>& newPlacements);
+
+  /**
+   * @brief Adds a step to the schedule. Call this with the same deltaTime as PhysicsWorld::step
+   *
+   * @param deltaTime The time of the step in seconds
+   */
+  void addStep(const float deltaTime);
+
+  /**
+   * @brief Stores how the run ended. Call this after the last step and before PhysicsWorld::reset
+   *
+   * @param world The world
+   */
+  void finish(PhysicsWorld& world);
+
+  /**
+   * @brief Plays the replay back in a new world, with the level that's stored in the replay
+   * @attention Throws an std::runtime_error if the stored level doesn't match its hash or is invalid.
+   * A replay without a stored level (from before [LevelData]) uses the level file, which throws if it has changed since the recording
+   *
+   * @param trajectory Gets filled with the position of the ball after every step when it isn't nullptr
+   * @return ReplayResult How the run ended
+   */
+  ReplayResult run(std::vector<sf::Vector2f>* trajectory = nullptr) const;
+
+  /**
+   * @brief Plays the replay back and compares it with the stored result
+   *
+   * @param message Gets set to what's different when it doesn't match
+   * @return true if the run ended exactly the same
+   */
+  bool verify(std::string& message) const;
+
+  /**
+   * @brief Saves the replay to a replay file (*.qr)
+   * @attention Throws an std::runtime_error if the file can't be written
+   *
+   * @param path The path to the replay file
+   */
+  void saveToFile(const std::filesystem::path path) const;
+
+  /**
+   * @brief Loads a replay file (*.qr)
+   * @attention Throws an std::runtime_error if the file can't be read
+   *
+   * @param path The path to the replay file
+   */
+  void loadFromFile(const std::filesystem::path path);
+
+  /**
+   * @brief Makes a replay without a stored level use another copy of the level file, for example when it was recorded on another machine
+   *
+   * @param newLevelPath The path to the level file (*.ql). It has to be the same level
+   */
+  void setLevelPath(const std::filesystem::path newLevelPath) {levelPath = newLevelPath;};
+
+  /**
+   * @brief Get the level path
+   *
+   * @return std::filesystem::path&
+   */
+  std::filesystem::path& getLevelPath() {return levelPath;};
+
+  /**
+   * @brief Get the placed items
+   *
+   * @return std::vector<Placement>&
+   */
+  std::vector<Placement>& getPlacements() {return placements;};
+
+  /**
+   * @brief Get the stored result
+   *
+   * @return ReplayResult&
+   */
+  ReplayResult& getResult() {return result;};
+
+  /**
+   * @brief Get the number of steps in the schedule
+   *
+   * @return uint32_t
+   */
+  uint32_t getStepCount() const;
+
+  /**
+   * @brief Hashes a text (64-bit FNV-1a), so a replay can tell if its level has changed
+   *
+   * @param text The text
+   * @return uint64_t The hash
+   */
+  static uint64_t hashText(std::string_view text);
+
+  /**
+   * @brief Hashes the contents of a file, the same way as hashText()
+   * @attention Throws an std::runtime_error if the file can't be read
+   *
+   * @param path The path to the file
+   * @return uint64_t The hash
+   */
+  static uint64_t hashFile(const std::filesystem::path path);
+
+private:
+
+  std::filesystem::path levelPath;
+  uint64_t levelHash = 0;
+  // The text of the level file, so the replay doesn't need the file anymore. Empty in replays from before [LevelData]
+  std::string levelText;
+
+  // The settings of the world, so the tools don't need a window to know them
+  float unitSize = 0.f;
+  sf::Vector2f levelSize;
+  sf::Vector2f ballOrigin;
+  float ballMass = 0.f;
+  float ballRadius = 0.f;
+
+  std::vector<Placement> placements;
+  // Runs of equal steps as (count, deltaTime). With a fixed time step this is a single entry
+  std::vector<std::pair<uint32_t, float>> schedule;
+
+  ReplayResult result;
+
+};
+
+#endif //REPLAY_H_
@@ -0,0 +1,241 @@
+#ifndef RESOURCES_H_
+#define RESOURCES_H_
+
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/pool.hpp"
+
+// Shared handles to loaded assets. Copying one is cheap and the asset stays alive as long as someone holds it
+using TextureHandle = std::shared_ptr<const sf::Texture>;
+using FontHandle = std::shared_ptr<const sf::Font>;
+using SoundBufferHandle = std::shared_ptr<const sf::SoundBuffer>;
+
+/**
+ * @brief A sprite that can be drawn: the texture it's in and where in that texture it is.
+ * For a sprite in an atlas, that's a part of the atlas page. Otherwise it's the whole texture
+ *
+ */
+struct SpriteRegion {
+  TextureHandle texture;
+  sf::IntRect rect;
+
+  /**
+   * @brief Get the size of the sprite in pixels
+   *
+   * @return sf::Vector2f
+   */
+  sf::Vector2f getSize() const {return sf::Vector2f(static_cast<float>(rect.width), static_cast<float>(rect.height));};
+};
+
+/**
+ * @brief Loads every texture, font and sound buffer once and hands out shared handles to it, so nothing gets decoded or uploaded twice.
+ * The game has one of these (see Globals::getResources). It can be used from any thread
+ *
+ */
+class ResourceCache {
+public:
+
+  /**
+   * @brief Get a texture, loading it the first time
+   * @attention Throws an std::runtime_error if the file can't be loaded
+   *
+   * @param path The path to the image file
+   * @param smooth Whether the texture gets smoothed when it's scaled. A smooth and a sharp version of the same file are two textures
+   * @return TextureHandle
+   */
+  TextureHandle getTexture(const std::filesystem::path& path, const bool smooth = false);
+
+  /**
+   * @brief Get a sprite. When it's packed in an atlas (see loadAtlas), it comes from the atlas page, so sprites share textures
+   * and can be drawn without switching textures. Otherwise this loads the file like getTexture
+   * @attention Throws an std::runtime_error if the file can't be loaded
+   *
+   * @param path The path to the image file. Atlases find the sprite by the file name
+   * @param smooth Whether the texture gets smoothed when it's scaled
+   * @return SpriteRegion
+   */
+  SpriteRegion getSprite(const std::filesystem::path& path, const bool smooth = false);
+
+  /**
+   * @brief Reads an atlas index (*.qa) that the atlas tool made. getSprite uses the atlas for every sprite in it after this
+   * @attention Throws an std::runtime_error if the index can't be read
+   *
+   * @param indexPath The path to the index. The pages are next to it
+   */
+  void loadAtlas(const std::filesystem::path& indexPath);
+
+  /**
+   * @brief Get the file that getSprite loads for a sprite: its atlas page, or the file itself when it isn't in an atlas
+   *
+   * @param path The path to the image file
+   * @return std::filesystem::path
+   */
+  std::filesystem::path getSpriteFile(const std::filesystem::path& path);
+
+  /**
+   * @brief Get a font, loading it the first time
+   * @attention Throws an std::runtime_error if the file can't be loaded
+   *
+   * @param path The path to the font file
+   * @return FontHandle
+   */
+  FontHandle getFont(const std::filesystem::path& path);
+
+  /**
+   * @brief Get a sound buffer, loading it the first time
+   * @attention Throws an std::runtime_error if the file can't be loaded
+   *
+   * @param path The path to the sound file
+   * @return SoundBufferHandle
+   */
+  SoundBufferHandle getSoundBuffer(const std::filesystem::path& path);
+
+  /**
+   * @brief Makes a texture from an image that was decoded somewhere else (see AssetPreloader). When the texture is already there, that one is kept
+   * @attention Uploads to the GPU, so only call this on the thread of the window. Throws an std::runtime_error if the upload fails
+   *
+   * @param path The path that the image was loaded from. getTexture finds the texture by it
+   * @param smooth Whether the texture gets smoothed when it's scaled
+   * @param image The decoded image
+   * @return TextureHandle
+   */
+  TextureHandle addTexture(const std::filesystem::path& path, const bool smooth, const sf::Image& image);
+
+  /**
+   * @brief Forgets the assets that nobody holds a handle to anymore. They get loaded again the next time they are needed
+   *
+   */
+  void clear();
+
+private:
+
+  /**
+   * @brief Adds a loaded asset, unless another thread added the same one in the meantime
+   *
+   * @param cache The map of the asset type
+   * @param key The key of the asset
+   * @param handle The asset that was just loaded
+   * @return The handle that is in the cache now
+   */
+  template <typename Key, typename Handle>
+  Handle insert(std::map<Key, Handle>& cache, const Key& key, Handle handle);
+
+  // Where a sprite is in an atlas
+  struct AtlasEntry {
+    std::filesystem::path page;
+    sf::IntRect rect;
+  };
+
+  // Only guards the maps. The files are loaded without it, so one big file doesn't hold up the other threads
+  std::mutex mutex;
+
+  std::map<std::pair<std::filesystem::path, bool>, TextureHandle> textures;
+  std::map<std::filesystem::path, FontHandle> fonts;
+  std::map<std::filesystem::path, SoundBufferHandle> soundBuffers;
+  std::map<std::string, AtlasEntry> atlas; // By file name
+
+};
+
+/**
+ * @brief Loads a list of assets into a ResourceCache on a WorkStealingPool, so the files are decoded in parallel.
+ * Sounds go into the cache straight from the workers. Textures need the OpenGL context of the window,
+ * so the workers only decode the images and upload() turns them into textures on the thread of the window
+ *
+ */
+class AssetPreloader {
+public:
+
+  /**
+   * @brief Construct a new Asset Preloader object
+   *
+   * @param cache The cache that gets the assets
+   */
+  AssetPreloader(ResourceCache& cache) : cache(cache) {};
+
+  AssetPreloader(const AssetPreloader&) = delete;
+  AssetPreloader& operator=(const AssetPreloader&) = delete;
+
+  /**
+   * @brief Adds a texture to the list. A sprite that is in an atlas loads its atlas page instead. Only call this before start()
+   *
+   * @param path The path to the image file
+   * @param smooth Whether the texture gets smoothed when it's scaled
+   */
+  void addTexture(const std::filesystem::path& path, const bool smooth = false);
+
+  /**
+   * @brief Adds a sound to the list. Only call this before start()
+   *
+   * @param path The path to the sound file
+   */
+  void addSoundBuffer(const std::filesystem::path& path);
+
+  /**
+   * @brief Gives every file to the pool
+   * @attention The tasks use this object, so the pool has to be done (or destroyed) before the preloader is destroyed
+   *
+   * @param pool The pool that decodes the files
+   */
+  void start(WorkStealingPool& pool);
+
+  /**
+   * @brief Uploads the images that have been decoded since the last call. Call this on the thread of the window until it returns true
+   * @attention Throws the error of the first file that couldn't be loaded
+   *
+   * @return true if every asset is in the cache
+   */
+  bool upload();
+
+  /**
+   * @brief Get the number of assets that are in the cache already
+   *
+   * @return size_t
+   */
+  size_t getLoaded() {return texturesUploaded + soundsLoaded;};
+
+  /**
+   * @brief Get the number of assets in the list
+   *
+   * @return size_t
+   */
+  size_t getTotal() {return textureJobs.size() + soundJobs.size();};
+
+private:
+
+  struct TextureJob {
+    std::filesystem::path path;
+    bool smooth;
+    sf::Image image; // Set by a worker, emptied again after the upload
+  };
+
+  ResourceCache& cache;
+
+  std::vector<TextureJob> textureJobs;
+  std::vector<std::filesystem::path> soundJobs;
+
+  // Guards decoded and error
+  std::mutex mutex;
+  std::vector<size_t> decoded; // The textureJobs whose image is ready for upload()
+  std::exception_ptr error;
+
+  size_t texturesUploaded = 0;
+  std::atomic<size_t> soundsLoaded{0};
+
+};
+
+#endif //RESOURCES_H_
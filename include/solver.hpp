@@ -0,0 +1,198 @@
+#ifndef SOLVER_H_
+#define SOLVER_H_
+
+#include <SFML/System/Vector2.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "../include/batch.hpp"
+#include "../include/level_data.hpp"
+#include "../include/pool.hpp"
+#include "../include/trajectory.hpp"
+#include "../include/world.hpp"
+
+/**
+ * @brief Settings of the LevelSolver
+ * 
+ */
+struct SolverConfig {
+  float unitSize = 57.f; // The level is 17 by 17 units, like in the game
+  float gridStep = 0.5f; // The distance between the positions that are tried, in units
+  float angleStep = 15.f; // The difference between the rotations that are tried, in degrees
+  unsigned int threads = 0; // 0 means one per hardware thread
+  size_t maxSolutions = 5; // Stop after finding this many. 0 means find all of them
+  size_t maxRuns = 0; // Stop after simulating this many runs. 0 means no limit
+  unsigned int maxTicks = 120 * 60; // A run that takes longer than this (in ticks of PhysicsWorld::TICK, so a minute) is seen as stuck
+};
+
+/**
+ * @brief Searches for placements of the items in a level's inventory that collect the needed money bags.
+ * 
+ * The search starts with an empty level and adds one item at a time. A new item is only tried where the ball actually goes
+ * in the run without it, so every placement changes the run. If the run doesn't change after all, the branch is dropped.
+ * The runs are spread over all cores with a WorkStealingPool. Every worker has its own PhysicsWorld.
+ * A state continues the run of the state without its last item from the last checkpoint before the ball came near that item (see TrajectoryCache).
+ * The states that use up the inventory only need their result, not their path, so they run in batches through the worker's BallBatch.
+ * 
+ */
+class LevelSolver {
+public:
+
+  /**
+   * @brief Construct a new Level Solver object and read the inventory and the number of needed bags from the level file
+   * 
+   * @param newLevelPath The path to the level file (*.ql)
+   * @param newConfig The settings
+   */
+  LevelSolver(const std::filesystem::path newLevelPath, const SolverConfig& newConfig);
+
+  /**
+   * @brief Searches for solutions
+   * 
+   * @return std::vector<std::vector<Placement>> The solutions that were found
+   */
+  std::vector<std::vector<Placement>> solve();
+
+  /**
+   * @brief Get the inventory. The index is the item ID and the value is how many of that item the player has
+   * 
+   * @return std::vector<uint16_t>& 
+   */
+  std::vector<uint16_t>& getInventory() {return inventory;};
+
+  /**
+   * @brief Get the number of money bags that have to be collected
+   * 
+   * @return unsigned int 
+   */
+  unsigned int getBagsNeeded() {return bagsNeeded;};
+
+  /**
+   * @brief Get the number of runs that were simulated by the last solve()
+   * 
+   * @return size_t 
+   */
+  size_t getRuns() {return runs;};
+
+  /**
+   * @brief Returns whether the last solve() stopped because of maxRuns. If not and there are no solutions, the level can't be solved with this grid and angle step
+   * 
+   */
+  bool hitRunLimit() {return runLimitHit;};
+
+  /**
+   * @brief Get the number of tasks that were stolen by another worker during the last solve()
+   * 
+   * @return size_t 
+   */
+  size_t getSteals() {return steals;};
+
+  /**
+   * @brief Get the number of threads that the last solve() used
+   * 
+   * @return size_t 
+   */
+  size_t getThreads() {return threads;};
+
+private:
+
+  /**
+   * @brief The outcome of one run
+   * 
+   */
+  struct RunResult {
+    unsigned int ticks = 0;
+    sf::Vector2f end;
+    unsigned int bags = 0;
+    std::shared_ptr<const TrajectoryCache> trajectory; // Shared by all of the states with one more item
+  };
+
+  /**
+   * @brief Simulates a run with some items placed
+   * 
+   * @param world The world of the worker
+   * @param placements The items
+   * @param parent The result of the run without the last item. Its trajectory is continued if it has one
+   * @return RunResult 
+   */
+  RunResult simulate(PhysicsWorld& world, const std::vector<Placement>& placements, const RunResult& parent);
+
+  /**
+   * @brief Simulates a state and, if it didn't solve the level yet, pushes the states with one more item
+   * 
+   * @param worker The index of the worker that runs this
+   * @param placements The items of this state
+   * @param parent The result of the state without the last item
+   */
+  void explore(const size_t worker, const std::vector<Placement>& placements, const RunResult& parent);
+
+  /**
+   * @brief Runs the states with one more item than a state at once, with a BallBatch, and keeps the ones that solve the level.
+   * For the states after which there is nothing left to place
+   * 
+   * @param worker The index of the worker that runs this
+   * @param placements The items of the state without the new item
+   * @param items The new items, one per state
+   * @param parent The result of the state without the new item
+   */
+  void evaluate(const size_t worker, const std::vector<Placement>& placements, const std::vector<Placement>& items, const RunResult& parent);
+
+  /**
+   * @brief Remembers a solution, and stops the search when there are enough of them
+   * 
+   * @param placements The items of the solution
+   */
+  void addSolution(const std::vector<Placement>& placements);
+
+  /**
+   * @brief Returns true if an item would be inside a wall, or the ball would start inside it
+   * 
+   * @param world The world of the worker
+   * @param placement The item
+   */
+  bool isBlocked(PhysicsWorld& world, const Placement& placement);
+
+  /**
+   * @brief Remembers a set of placements. Returns false if it was seen before (in any order)
+   * 
+   * @param placements The items
+   */
+  bool markVisited(const std::vector<Placement>& placements);
+
+  std::filesystem::path levelPath;
+  LevelDataHandle levelData;
+  SolverConfig config;
+
+  std::vector<uint16_t> inventory;
+  unsigned int bagsNeeded = 0;
+
+  // The positions that get tried, in pixels
+  std::vector<sf::Vector2i> lattice;
+  sf::Vector2u latticeSize;
+
+  // Per worker
+  std::vector<std::unique_ptr<PhysicsWorld>> worlds;
+  std::vector<std::unique_ptr<BallBatch>> batches; // On the world of the same worker
+  WorkStealingPool* pool = nullptr;
+
+  std::mutex visitedMutex;
+  std::set<std::vector<int64_t>> visited;
+
+  std::mutex solutionsMutex;
+  std::vector<std::vector<Placement>> solutions;
+
+  std::atomic<size_t> runs{0};
+  std::atomic<bool> done{false};
+  std::atomic<bool> runLimitHit{false};
+  size_t steals = 0;
+  size_t threads = 0;
+
+};
+
+#endif // SOLVER_H_
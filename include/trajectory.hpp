@@ -0,0 +1,113 @@
+#ifndef TRAJECTORY_H_
+#define TRAJECTORY_H_
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <vector>
+
+#include "../include/world.hpp"
+
+// Remembers a run step by step, with a WorldState every few steps. When an item is added, moved or removed,
+// the run only has to be simulated again from the last checkpoint before the ball first came near it.
+// The TrajectoryPreview and the LevelSolver use it, so moving an item late in the path only costs the rest of the run.
+
+class TrajectoryCache {
+public:
+
+  // The number of steps between two checkpoints. A rewind simulates at most this many steps that it had already done
+  static const unsigned short CHECKPOINT_INTERVAL = 30;
+
+  /**
+   * @brief Forgets the old run and starts a new one at the current state of the world (usually right after PhysicsWorld::reset)
+   *
+   * @param world The world
+   */
+  void start(PhysicsWorld& world);
+
+  /**
+   * @brief Remembers the step that the world just took. Call it after every PhysicsWorld::tick (or every PhysicsWorld::step when the world isn't moved in ticks)
+   *
+   * @param world The world
+   */
+  void record(PhysicsWorld& world);
+
+  /**
+   * @brief Goes back to the last checkpoint before the ball first came near an area where a collider was added or removed,
+   * and puts the world in the state of that checkpoint. Simulating the world from there gives the same run as simulating it from the start
+   *
+   * @param world The world, with the colliders already changed
+   * @param boundsMin The top-left corner of the area
+   * @param boundsMax The bottom-right corner of the area
+   * @return size_t The step that the run continues from
+   */
+  size_t rewind(PhysicsWorld& world, const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax);
+
+  /**
+   * @brief Same as the other rewind, but continues a run that another cache remembered. Only copies the part of it before the checkpoint
+   *
+   * @param from The cache with the run before the change
+   * @param world The world, with the colliders already changed
+   * @param boundsMin The top-left corner of the area
+   * @param boundsMax The bottom-right corner of the area
+   * @return size_t The step that the run continues from
+   */
+  size_t rewind(const TrajectoryCache& from, PhysicsWorld& world, const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax);
+
+  /**
+   * @brief Finds the state that a rewind would continue the run from, without copying anything. For a BallBatch, which only needs where each run starts
+   * @attention The cache can't be empty
+   *
+   * @param boundsMin The top-left corner of the area where a collider was added or removed
+   * @param boundsMax The bottom-right corner of the area
+   * @param ballRadius The radius of the ball
+   * @param step Gets the step of the state
+   * @return const WorldState& The state. It belongs to the cache, so it lives as long as the cache isn't changed
+   */
+  const WorldState& getRewindState(const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax, const float ballRadius, size_t& step) const;
+
+  /**
+   * @brief Returns whether there is a run to rewind
+   *
+   */
+  bool isEmpty() const {return checkpoints.empty();};
+
+  /**
+   * @brief Get the number of steps of the run so far
+   *
+   * @return size_t
+   */
+  size_t getSteps() const {return points.empty() ? 0 : points.size() - 1;};
+
+  /**
+   * @brief Get the positions of the ball, starting where the run started and then one after every step
+   *
+   * @return const std::vector<sf::Vector2f>&
+   */
+  const std::vector<sf::Vector2f>& getPoints() const {return points;};
+
+private:
+
+  struct Checkpoint {
+    size_t step;
+    WorldState state;
+  };
+
+  /**
+   * @brief Finds the last checkpoint before the first step in which the ball could have touched an area
+   *
+   * @param boundsMin The top-left corner of the area
+   * @param boundsMax The bottom-right corner of the area
+   * @param ballRadius The radius of the ball
+   * @return size_t The index in checkpoints
+   */
+  size_t findCheckpoint(const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax, const float ballRadius) const;
+
+  std::vector<sf::Vector2f> points;
+  // The area that the ball could touch in every step (see PhysicsWorld::getStepBounds). Index 0 is the first step
+  std::vector<sf::Vector2f> stepBoundsMin;
+  std::vector<sf::Vector2f> stepBoundsMax;
+  std::vector<Checkpoint> checkpoints;
+
+};
+
+#endif //TRAJECTORY_H_
@@ -17,6 +17,8 @@
 
 #include "../include/globals.hpp"
 #include "../include/config.hpp"
+#include "../include/render.hpp"
+#include "../include/resources.hpp"
 
 namespace UIElements {
 
@@ -41,7 +43,7 @@ namespace UIElements {
      * @param newFontSize Specific font size (optional, -1 to scale text to fit)
      */
     Button(
-      const sf::Texture& tOuter, const sf::Vector2f& vPos, const sf::Vector2u& vSize, std::string buttonText = "", const sf::Color& newColor = sf::Color::Black, const int newFontSize = -1
+      const SpriteRegion& tOuter, const sf::Vector2f& vPos, const sf::Vector2u& vSize, std::string buttonText = "", const sf::Color& newColor = sf::Color::Black, const int newFontSize = -1
     ) :
     textSize(0.8f), fontSize(newFontSize), outer(tOuter), text(buttonText), textColor(newColor), position(vPos), size(vSize) {};
 
@@ -106,14 +108,14 @@ namespace UIElements {
      * 
      * @param newTexture 
      */
-    void setOuterTexture(const sf::Texture& newTexture) {outer = newTexture;};
+    void setOuterTexture(const SpriteRegion& newTexture) {outer = newTexture;};
     
     /**
      * @brief Get the outer texture
      * 
-     * @return sf::Texture& 
+     * @return const SpriteRegion& 
      */
-    sf::Texture& getOuterTexture() {return outer;};
+    const SpriteRegion& getOuterTexture() {return outer;};
     
     /**
      * @brief Checks if a point is in the button using simple AABB
@@ -143,7 +145,7 @@ namespace UIElements {
 
     int fontSize = 0;
 
-    sf::Texture outer;
+    SpriteRegion outer;
     std::string text;
     sf::Color textColor;
 
@@ -171,7 +173,7 @@ namespace UIElements {
      * @param buttonText Text that needs to be displayed on the button (optional)
      */
     RunButton(
-      const sf::Texture& tOuter, const sf::Vector2f& vPos, const sf::Vector2u& vSize, std::string buttonText = "Run", const sf::Color& newColor = sf::Color::Black
+      const SpriteRegion& tOuter, const sf::Vector2f& vPos, const sf::Vector2u& vSize, std::string buttonText = "Run", const sf::Color& newColor = sf::Color::Black
     ) : Button(tOuter, vPos, vSize, buttonText, newColor) {};
 
     /**
@@ -199,7 +201,7 @@ namespace UIElements {
      * @param lockAspectRario Locks the aspect ratio of the item sprite
      */
     InventoryButton(
-      const int8_t itemId, const sf::Texture& tOuter, const sf::Vector2f& vPos, const sf::Vector2u& vSize, const std::filesystem::path pathInner,
+      const int8_t itemId, const SpriteRegion& tOuter, const sf::Vector2f& vPos, const sf::Vector2u& vSize, const std::filesystem::path pathInner,
       const sf::Vector2f& itemRealSize, int16_t newCount = -1, bool lockAspectRario = false
     ) : Button(tOuter, vPos, vSize), itemId(itemId), itemSize(0.7f), innerPath(pathInner), innerSize(itemRealSize), lockAspect(lockAspectRario), count(newCount) {};
 
@@ -250,6 +252,7 @@ namespace UIElements {
     float itemSize;
 
     std::filesystem::path innerPath;
+    SpriteRegion inner; // Loaded when the button is drawn for the first time
     sf::Vector2f innerSize;
 
     bool lockAspect;
@@ -267,7 +270,7 @@ namespace UIElements {
      * @param newCounts A list of all the item's count
      * @param buttonOuter The texture for the background of the button
      */
-    Inventory(const std::vector<int8_t>& newItems, const std::vector<int16_t>& newCounts, sf::Texture& buttonOuter);
+    Inventory(const std::vector<int8_t>& newItems, const std::vector<int16_t>& newCounts, const SpriteRegion& buttonOuter);
 
     /**
      * @brief Destroy the Inventory object
@@ -331,7 +334,7 @@ namespace UIElements {
     std::vector<int16_t> counts;
     std::vector<UIElements::InventoryButton*> buttons;
 
-    sf::Texture& outerTexture;
+    SpriteRegion outerTexture;
 
     std::string spritePath = std::string(RESOURCES_PATH) + "sprites/";
 
@@ -370,7 +373,7 @@ namespace UIElements {
      * @param font The font to use. Default is the main font.
      * @param newFontSize Specific size of the font (optional, -1 to scale to fit)
      */
-    TextLabel(const std::string newText, const sf::Vector2f& newPos, const sf::Vector2f& newSize, const std::filesystem::path backgroundPath, const sf::Color& textColor = sf::Color::White, const sf::Font& font = Globals::mainFont, const int newFontSize = -1);
+    TextLabel(const std::string newText, const sf::Vector2f& newPos, const sf::Vector2f& newSize, const std::filesystem::path backgroundPath, const sf::Color& textColor = sf::Color::White, const sf::Font& font = Globals::getMainFont(), const int newFontSize = -1);
 
     /**
      * @brief Set the text and updates the size
@@ -418,19 +421,20 @@ namespace UIElements {
     /**
      * @brief Get the background texture
      * 
-     * @return sf::Texture& 
+     * @return const SpriteRegion& 
      */
-    sf::Texture& getBackground() {return background;};
+    const SpriteRegion& getBackground() {return background;};
 
     /**
      * @brief Draws the text label on the screen
      * 
+     * @param layer The layer of the render queue that the background and the text go in
      */
-    void draw();
+    void draw(const RenderQueue::Layer layer = RenderQueue::UI);
 
   private:
 
-    sf::Texture background;
+    SpriteRegion background;
     
     std::string text;
     sf::Vector2f pos;
@@ -0,0 +1,482 @@
+#ifndef WORLD_H_
+#define WORLD_H_
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <vector>
+
+#include "../include/grid.hpp"
+#include "../include/level_data.hpp"
+#include "../include/physics.hpp"
+
+// The headless part of a level: everything the ball can touch, without any windows, textures or audio.
+// Both the game and the tools link this through the SorryWereBroke_physics library.
+
+class BouncyObjects {
+public:
+
+  /**
+   * @brief Generates the walls
+   *
+   * @param levelSize The size of the level in pixels (the size of the window in the game)
+   * @param unitSize The conversion factor from units to pixels
+   */
+  void makeWalls(const sf::Vector2f levelSize, const float unitSize);
+
+  /**
+   * @brief Generates a new BounyObject
+   *
+   * @param points The points that make up the shape
+   * @param cor Coefficient of restitution, which is the factor that the speed gets multiplied with upon colision
+   * @param orientation The orientation of the object. This is a vector pointing to the right edge of the object
+   */
+  void makeBO(const PhysicsObjects::Points& points, const float cor, const sf::Vector2f orientation = sf::Vector2f(1,0));
+
+  /**
+   * @brief Generates the BouncyObjects of a level
+   *
+   * @param data The level
+   * @param unitSize The conversion factor from units to pixels
+   */
+  void load(const LevelData& data, const float unitSize);
+
+  /**
+   * @brief Get the list of BouncyObjects
+   *
+   * @return std::vector<PhysicsObjects::BouncyObject>& A reference to the BouncyObjects list
+   */
+  std::vector<PhysicsObjects::BouncyObject>& getList() {return bo_list;};
+
+private:
+
+  std::vector<PhysicsObjects::BouncyObject> bo_list;
+
+};
+
+/**
+ * @brief The physics side of a money bag. The MoneyBag in level.hpp only draws it
+ *
+ */
+struct MoneyBagState {
+  sf::Vector2f pos;
+  uint8_t value = 5;
+  bool collected = false;
+};
+
+/**
+ * @brief Checks collision between the ball and a money bag
+ *
+ * @param bagPos The position of the money bag
+ * @param unitSize The conversion factor from units to pixels
+ * @param ball The ball
+ * @return true if the ball hits the money bag
+ */
+bool intersectMoneyBag(const sf::Vector2f& bagPos, const float unitSize, PhysicsObjects::Ball& ball);
+
+/**
+ * @brief Same as the other intersectMoneyBag, but for a ball that isn't a Ball object (see BallBatch)
+ *
+ * @param bagPos The position of the money bag
+ * @param unitSize The conversion factor from units to pixels
+ * @param midpoint The midpoint of the ball
+ * @param radius The radius of the ball
+ * @return true if the ball hits the money bag
+ */
+bool intersectMoneyBag(const sf::Vector2f& bagPos, const float unitSize, const sf::Vector2f& midpoint, const float radius);
+
+/**
+ * @brief An item that the player placed. This is all that's needed to put it back in the world (see PhysicsWorld::addItem)
+ *
+ */
+struct Placement {
+  int8_t itemId; // The same IDs as the inventory: 0 is a bounce pad, 1 is a booster
+  sf::Vector2i position; // In pixels, like the mouse position in GhostObject::place
+  float rotation; // In degrees
+};
+
+/**
+ * @brief Get the size of an item
+ *
+ * @param itemId The ID of the item. Only the bounce pad (0) and the booster (1) have physics
+ * @return sf::Vector2f The size in units. Same as itemIdToSize in ui.hpp
+ */
+sf::Vector2f getItemSize(const int8_t itemId);
+
+/**
+ * @brief Everything about a run that changes while it's going. PhysicsWorld::loadState() puts it back, so a run can continue from the middle (see TrajectoryCache)
+ *
+ */
+struct WorldState {
+  /**
+   * @brief An object that the ball is touching. The level's objects are stored by their key in the grid,
+   * the user's objects by USER_KEY | their place in the order in which they were added, so the state still fits a world in which the same items got other IDs
+   *
+   */
+  struct Touching {
+    size_t key;
+    short justBounced;
+    bool justBoosted;
+  };
+
+  sf::Vector2f ballMidpoint;
+  sf::Vector2f ballVelocity;
+  std::vector<bool> collected; // One for every money bag
+  std::vector<Touching> touching;
+  bool finished = false;
+};
+
+class PhysicsWorld {
+public:
+
+  /**
+   * @brief Things that happened during a step that the game might want to play a sound for or draw
+   *
+   */
+  enum class EventType {
+    BOUNCE_WALL,
+    BOUNCE_PAD,
+    BOOST_FASTER,
+    BOOST_SLOWER,
+    MONEY_BAG // index is the index of the money bag
+  };
+
+  struct Event {
+    EventType type;
+    size_t index;
+  };
+
+  /**
+   * @brief An object that the user placed. Only one of the two colliders is used
+   *
+   */
+  struct UserObject {
+    bool isBooster;
+    PhysicsObjects::BouncyObject bouncyObject;
+    PhysicsObjects::Booster booster;
+  };
+
+  // How many times the ball can hit something during one step
+  static const unsigned short MAX_SWEEPS = 8;
+  // A ball that is slower than this (in pixels per second) while touching something has come to rest
+  static constexpr float REST_VELOCITY = 25.f;
+  // The ball counts as still touching an object while it is less than this part of its radius away from it.
+  // The sweep stops the ball exactly at the surface, so without it a ball bouncing straight up and down never slows below REST_VELOCITY while touching
+  static constexpr float CONTACT_SKIN = 0.25f;
+  // The longest step that getSubstep() gives, so a faster time scale doesn't make the gravity less accurate
+  static constexpr float MAX_SUBSTEP = 1.f / 60.f;
+  // The shortest step that getSubstep() gives, so a very fast ball can't make a frame take forever
+  static constexpr float MIN_SUBSTEP = 1.f / 4000.f;
+  // The length of a tick in seconds. The game, the trajectory preview and the solver all move the world forward with tick(),
+  // so the same placements give the same run in all of them, no matter the frame rate
+  static constexpr float TICK = 1.f / 120.f;
+  // The keys in the grid are the index in the BouncyObjects list for the level's objects
+  // and USER_KEY | id for the user's objects. So in a sorted list of keys, the level comes first
+  static const size_t USER_KEY = static_cast<size_t>(1) << (sizeof(size_t) * 8 - 1);
+
+  /**
+   * @brief Construct a new Physics World object
+   *
+   * @param newUnitSize The conversion factor from units to pixels
+   * @param newLevelSize The size of the level in pixels. The ball is outside of the level when it leaves this area
+   * @param newBallOrigin The position where the ball starts
+   * @param ballMass The mass of the ball
+   * @param ballRadius The radius of the ball in pixels
+   */
+  PhysicsWorld(const float newUnitSize, const sf::Vector2f newLevelSize, const sf::Vector2f newBallOrigin, const float ballMass = 0.1f, const float ballRadius = 20.f)
+  : unitSize(newUnitSize), levelSize(newLevelSize), ballOrigin(newBallOrigin), ball(newBallOrigin, ballMass, ballRadius), grid(newUnitSize, newLevelSize) {};
+
+  /**
+   * @brief Loads the walls, the BouncyObjects and the money bags of a level. Removes the previous level, but keeps the user's objects
+   *
+   * @param data The level
+   */
+  void load(const LevelData& data);
+
+  /**
+   * @brief Same as load(), but reads the level file (*.ql) first
+   * @attention Throws an std::runtime_error if the file can't be read
+   *
+   * @param path The path to the level file
+   */
+  void loadFromFile(const std::filesystem::path path) {load(*loadLevelData(path));};
+
+  /**
+   * @brief Adds a bounce pad or another user-placed BouncyObject
+   *
+   * @param object The object. The world keeps its own copy
+   * @return size_t The ID to remove the object with
+   */
+  size_t addBouncyObject(const PhysicsObjects::BouncyObject& object);
+
+  /**
+   * @brief Adds a booster
+   *
+   * @param booster The booster. The world keeps its own copy
+   * @return size_t The ID to remove the booster with
+   */
+  size_t addBooster(const PhysicsObjects::Booster& booster);
+
+  /**
+   * @brief Adds a bounce pad or a booster the same way as GhostObject::place does
+   * @attention Throws an std::runtime_error for items that don't have physics
+   *
+   * @param placement The item
+   * @return size_t The ID to remove the item with
+   */
+  size_t addItem(const Placement& placement);
+
+  /**
+   * @brief Makes the collider of a bounce pad or a booster, the way addItem() adds it
+   * @attention Throws an std::runtime_error for items that don't have physics
+   *
+   * @param placement The item
+   * @param unitSize The conversion factor from units to pixels
+   * @return UserObject
+   */
+  static UserObject makeUserObject(const Placement& placement, const float unitSize);
+
+  /**
+   * @brief Removes a user-placed object
+   *
+   * @param id The ID that addBouncyObject() or addBooster() returned
+   */
+  void removeUserObject(const size_t id);
+
+  /**
+   * @brief Removes all of the user-placed objects
+   *
+   */
+  void clearUserObjects();
+
+  /**
+   * @brief Puts the ball back at its origin, resets the money bags and starts a new run
+   *
+   */
+  void reset();
+
+  /**
+   * @brief Moves the simulation forward by deltaTime
+   *
+   * @param deltaTime The time to simulate in seconds
+   * @return true if the run is still going
+   * @return false if the run has finished (the ball came to a rest or left the level)
+   */
+  bool step(const float deltaTime);
+
+  /**
+   * @brief Moves the simulation forward by one TICK. A fast ball splits the tick into shorter steps (see getSubstep)
+   *
+   * @return true if the run is still going
+   * @return false if the run has finished
+   */
+  bool tick();
+
+  /**
+   * @brief Get the steps that the last tick() took, so a Replay can record them
+   *
+   * @return const std::vector<float>& The lengths of the steps in seconds
+   */
+  const std::vector<float>& getTickSteps() {return tickSteps;};
+
+  /**
+   * @brief Stores the ball, the money bags and the objects that the ball is touching
+   *
+   * @param state Gets the state of the run
+   */
+  void saveState(WorldState& state);
+
+  /**
+   * @brief Continues a run from a state that saveState() stored. The colliders stay like they are.
+   * The run only ends the same way as the one that was saved if the colliders that were added or removed since then are out of the ball's reach until this point
+   * @attention Throws an std::runtime_error if the state has another number of money bags
+   *
+   * @param state The state. User objects that don't exist anymore are skipped
+   */
+  void loadState(const WorldState& state);
+
+  /**
+   * @brief Finds the object in this world that a key in a WorldState belongs to (see WorldState::Touching)
+   *
+   * @param stateKey The key in the state
+   * @param key Gets set to the key in the grid
+   * @return true if the object still exists
+   */
+  bool getStateKey(const size_t stateKey, size_t& key);
+
+  /**
+   * @brief Get the area that the ball could touch during the last step or tick: the areas that it searched the grid in, so a collider outside of it can't have changed it
+   *
+   * @param boundsMin Gets the top-left corner of the area
+   * @param boundsMax Gets the bottom-right corner of the area
+   */
+  void getStepBounds(sf::Vector2f& boundsMin, sf::Vector2f& boundsMax) {boundsMin = stepBoundsMin; boundsMax = stepBoundsMax;};
+
+  /**
+   * @brief Get the length of the next step when the simulation has to move forward by more than one step at a time (fast-forwarding).
+   * The faster the ball, the shorter the step: the ball moves at most its radius per step
+   *
+   * @param maxTime The time that is left to simulate in seconds
+   * @return float The time to call step() with. At most maxTime and MAX_SUBSTEP
+   */
+  float getSubstep(const float maxTime);
+
+  /**
+   * @brief Same as the other getSubstep, but for a ball that isn't the world's ball (see BallBatch)
+   *
+   * @param maxTime The time that is left to simulate in seconds
+   * @param speed The speed of the ball in pixels per second
+   * @param radius The radius of the ball in pixels
+   * @return float The time to step with
+   */
+  static float getSubstep(const float maxTime, const float speed, const float radius);
+
+  /**
+   * @brief Returns whether the run has finished
+   *
+   */
+  bool isFinished() {return finished;};
+
+  /**
+   * @brief Get the ball
+   *
+   * @return PhysicsObjects::Ball&
+   */
+  PhysicsObjects::Ball& getBall() {return ball;};
+
+  /**
+   * @brief Get the ball origin
+   *
+   * @return sf::Vector2f&
+   */
+  sf::Vector2f& getBallOrigin() {return ballOrigin;};
+
+  /**
+   * @brief Get the level's BouncyObjects (including the walls)
+   *
+   * @return BouncyObjects&
+   */
+  BouncyObjects& getBouncyObjects() {return bouncyObjects;};
+
+  /**
+   * @brief Get the collider that belongs to a key in the grid
+   *
+   * @param key The key
+   * @param isBooster Gets set to whether the collider is a booster
+   * @return PhysicsObjects::BouncyObject& The collider. Cast it to a Booster if isBooster is true
+   */
+  PhysicsObjects::BouncyObject& getCollider(const size_t key, bool& isBooster);
+
+  /**
+   * @brief Gets the keys of the colliders near an area (see CollisionGrid::query)
+   *
+   * @param boundsMin The top-left corner of the area
+   * @param boundsMax The bottom-right corner of the area
+   * @param keys Gets filled with the keys, sorted and without duplicates
+   */
+  void queryColliders(const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax, std::vector<size_t>& keys) {grid.query(boundsMin, boundsMax, keys);};
+
+  /**
+   * @brief Get the money bags
+   *
+   * @return std::vector<MoneyBagState>&
+   */
+  std::vector<MoneyBagState>& getMoneyBags() {return moneyBags;};
+
+  /**
+   * @brief Get the total value of the collected money bags
+   *
+   * @return uint16_t
+   */
+  uint16_t getCollectedValue();
+
+  /**
+   * @brief Get the events of the steps since the last clearEvents()
+   *
+   * @return std::vector<Event>&
+   */
+  std::vector<Event>& getEvents() {return events;};
+
+  /**
+   * @brief Clears the event list
+   *
+   */
+  void clearEvents() {events.clear();};
+
+  /**
+   * @brief Get the revision of the colliders. It goes up every time an object is added or removed or a level is loaded
+   *
+   * @return size_t
+   */
+  size_t getRevision() {return revision;};
+
+  /**
+   * @brief Get the unit size
+   *
+   * @return float
+   */
+  float getUnitSize() {return unitSize;};
+
+  /**
+   * @brief Get the level size
+   *
+   * @return sf::Vector2f
+   */
+  sf::Vector2f getLevelSize() {return levelSize;};
+
+private:
+
+  /**
+   * @brief Adds a user's object to the grid
+   *
+   * @param id The ID of the object
+   */
+  void insertUserObject(const size_t id);
+
+  /**
+   * @brief Moves the ball, bouncing and boosting it at the exact moment it hits something (see BouncyObject::sweepBallCollision)
+   *
+   * @param deltaTime The time to move the ball for
+   * @return true if the ball has come to rest against something
+   */
+  bool sweep(float deltaTime);
+
+  /**
+   * @brief Clears justBounced and justBoosted of the objects the ball has left and checks if the run has finished
+   *
+   * @return true if the run has finished
+   */
+  bool checkCollisions();
+
+  float unitSize;
+  sf::Vector2f levelSize;
+  sf::Vector2f ballOrigin;
+
+  PhysicsObjects::Ball ball;
+
+  BouncyObjects bouncyObjects;
+  // Sorted by ID, which is the order in which they were added
+  std::map<size_t, UserObject> userObjects;
+  size_t nextId = 0;
+
+  CollisionGrid grid;
+  std::vector<size_t> nearbyKeys; // The result of the last grid query. It's a member so the memory gets reused
+  std::vector<size_t> touchingKeys; // The objects with justBounced or justBoosted set
+  sf::Vector2f stepBoundsMin;
+  sf::Vector2f stepBoundsMax;
+  std::vector<float> tickSteps; // The steps of the last tick
+
+  size_t revision = 0;
+
+  std::vector<MoneyBagState> moneyBags;
+  std::vector<sf::Vector2f> moneyBagOrigins;
+
+  std::vector<Event> events;
+
+  bool finished = false;
+
+};
+
+#endif //WORLD_H_
@@ -4,28 +4,144 @@
  * @brief Handles the audio
  * @version 0.1
  * @date 2024-04-25
- * 
+ *
  * @copyright Copyright (c) 2024
- * 
+ *
  */
 
 #include "../include/audio.hpp"
 
 #include <SFML/Audio/Sound.hpp>
 #include <SFML/Audio/SoundBuffer.hpp>
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
 
 #include "../include/globals.hpp"
 
-void playSound(sf::SoundBuffer buffer) {
-  sf::Sound* sound = new sf::Sound(buffer);
+//////////////////////////////////////
+// AudioEngine
+//////////////////////////////////////
 
-  sound->setVolume(Globals::volume);
-  sound->play();
+AudioEngine::AudioEngine() {
+  static_assert((QUEUE_SIZE & (QUEUE_SIZE - 1)) == 0, "QUEUE_SIZE has to be a power of 2");
 
-  while (sound->getStatus() == sf::Sound::Playing) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  for (size_t i = 0; i < QUEUE_SIZE; ++i) {
+    this->slots[i].sequence.store(i, std::memory_order_relaxed);
   }
-  
-  delete sound;
-}
\ No newline at end of file
+
+  // All of the voices are made here, so playing a sound never allocates
+  this->voices.resize(NUM_VOICES);
+  for (Voice& voice : this->voices) {
+    voice.sound = std::make_unique<sf::Sound>(this->silence);
+  }
+}
+
+AudioEngine::~AudioEngine() {
+  this->stop();
+}
+
+void AudioEngine::start() {
+  if (this->running) {
+    return;
+  }
+  this->running = true;
+  this->thread = std::thread(&AudioEngine::run, this);
+}
+
+void AudioEngine::stop() {
+  if (!this->running) {
+    return;
+  }
+  this->running = false;
+  this->wake.notify_one();
+  this->thread.join();
+
+  for (Voice& voice : this->voices) {
+    voice.sound->stop();
+    voice.sound->setBuffer(this->silence);
+    voice.buffer.reset();
+  }
+}
+
+bool AudioEngine::play(const std::shared_ptr<const sf::SoundBuffer>& buffer) {
+  // Claim a slot by moving the tail forward. Other threads can push at the same time, so this retries until it wins or the queue is full
+  size_t position = this->tail.load(std::memory_order_relaxed);
+  Slot* slot;
+  while (true) {
+    slot = &this->slots[position & (QUEUE_SIZE - 1)];
+    const size_t SEQUENCE = slot->sequence.load(std::memory_order_acquire);
+    if (SEQUENCE == position) {
+      if (this->tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (SEQUENCE < position) {
+      // The audio thread hasn't taken the event out of this slot yet
+      return false;
+    } else {
+      position = this->tail.load(std::memory_order_relaxed);
+    }
+  }
+
+  slot->event.buffer = buffer;
+  slot->event.volume = Globals::volume;
+  slot->sequence.store(position + 1, std::memory_order_release);
+
+  this->wake.notify_one();
+  return true;
+}
+
+bool AudioEngine::pop(PlayEvent& event) {
+  Slot& slot = this->slots[this->head & (QUEUE_SIZE - 1)];
+  if (slot.sequence.load(std::memory_order_acquire) != this->head + 1) {
+    return false;
+  }
+
+  event = std::move(slot.event);
+  slot.event.buffer.reset();
+  // Free the slot for the push that comes one lap later
+  slot.sequence.store(this->head + QUEUE_SIZE, std::memory_order_release);
+  ++this->head;
+  return true;
+}
+
+AudioEngine::Voice& AudioEngine::getFreeVoice() {
+  Voice* oldest = &this->voices[0];
+  for (Voice& voice : this->voices) {
+    if (voice.sound->getStatus() != sf::Sound::Playing) {
+      return voice;
+    }
+    if (voice.startedAt < oldest->startedAt) {
+      oldest = &voice;
+    }
+  }
+  oldest->sound->stop();
+  return *oldest;
+}
+
+void AudioEngine::run() {
+  PlayEvent event;
+  while (this->running) {
+
+    while (this->pop(event)) {
+      Voice& voice = this->getFreeVoice();
+      voice.sound->setBuffer(*event.buffer);
+      voice.buffer = std::move(event.buffer);
+      voice.sound->setVolume(event.volume);
+      voice.sound->play();
+      voice.startedAt = ++this->playCount;
+    }
+
+    // A push can happen right after the queue was found empty and before the wait starts, so don't wait forever
+    std::unique_lock<std::mutex> lock(this->wakeMutex);
+    this->wake.wait_for(lock, std::chrono::milliseconds(IDLE_WAIT_MS), [this] {
+      return !this->running || this->slots[this->head & (QUEUE_SIZE - 1)].sequence.load(std::memory_order_acquire) == this->head + 1;
+    });
+
+  }
+}
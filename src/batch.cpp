@@ -0,0 +1,314 @@
+/**
+ * @file batch.cpp
+ * @author Patrick Vreeburg
+ * @brief Simulates a lot of balls at once
+ * @version 0.1
+ * @date 2024-06-02
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "../include/batch.hpp"
+
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../include/math.hpp"
+#include "../include/physics.hpp"
+#include "../include/trajectory.hpp"
+#include "../include/world.hpp"
+
+size_t BallBatch::addBall(const sf::Vector2f position, const sf::Vector2f velocity, const float mass, const float radius) {
+  if (this->size() == 0) {
+    this->numBags = this->world.getMoneyBags().size();
+  }
+
+  this->positionX.push_back(position.x);
+  this->positionY.push_back(position.y);
+  this->velocityX.push_back(velocity.x);
+  this->velocityY.push_back(velocity.y);
+  this->radius.push_back(radius);
+  this->mass.push_back(mass);
+  this->finished.push_back(false);
+  this->ticks.push_back(0);
+  this->item.push_back(NO_ITEM);
+
+  const size_t INDEX = this->size() - 1;
+  if (this->touchingKeys.size() <= INDEX) {
+    this->touchingKeys.emplace_back();
+  }
+  this->touchingKeys[INDEX].clear();
+
+  this->collected.resize(this->collected.size() + this->numBags, false);
+
+  return INDEX;
+}
+
+size_t BallBatch::addBall(const WorldState& state, const uint32_t startTick) {
+  if (state.collected.size() != this->world.getMoneyBags().size()) {
+    throw std::runtime_error("The state belongs to another level.");
+  }
+
+  PhysicsObjects::Ball& ball = this->world.getBall();
+  const size_t INDEX = this->addBall(state.ballMidpoint, state.ballVelocity, ball.getMass(), ball.getRadius());
+  this->finished[INDEX] = state.finished;
+  this->ticks[INDEX] = startTick;
+
+  for (size_t bag = 0; bag < this->numBags; ++bag) {
+    this->collected[INDEX * this->numBags + bag] = state.collected[bag];
+  }
+
+  for (const WorldState::Touching& touching : state.touching) {
+    size_t key;
+    if (this->world.getStateKey(touching.key, key)) {
+      this->touchingKeys[INDEX].push_back(key);
+    }
+  }
+
+  return INDEX;
+}
+
+size_t BallBatch::addBall(const TrajectoryCache& from, const Placement& newItem) {
+  PhysicsWorld::UserObject newObject = PhysicsWorld::makeUserObject(newItem, this->world.getUnitSize());
+  PhysicsObjects::BouncyObject& collider = newObject.isBooster ? newObject.booster : newObject.bouncyObject;
+
+  size_t step;
+  const WorldState& STATE = from.getRewindState(collider.getBoundsMin(), collider.getBoundsMax(), this->world.getBall().getRadius(), step);
+  const size_t INDEX = this->addBall(STATE, static_cast<uint32_t>(step));
+
+  this->items.push_back(std::move(newObject));
+  this->item[INDEX] = this->items.size() - 1;
+  return INDEX;
+}
+
+void BallBatch::clear() {
+  for (std::vector<float>* array : {&this->positionX, &this->positionY, &this->velocityX, &this->velocityY, &this->radius, &this->mass}) {
+    array->clear();
+  }
+  this->finished.clear();
+  this->ticks.clear();
+  this->item.clear();
+  this->items.clear();
+  this->collected.clear();
+  this->numBags = 0;
+}
+
+uint16_t BallBatch::getCollectedValue(const size_t i) {
+  uint16_t value = 0;
+  for (size_t bag = 0; bag < this->numBags; ++bag) {
+    if (this->collected[i * this->numBags + bag]) value += this->world.getMoneyBags()[bag].value;
+  }
+  return value;
+}
+
+PhysicsObjects::BouncyObject& BallBatch::getCollider(const size_t i, const size_t key, bool& isBooster) {
+  if (key != ITEM_KEY) {
+    return this->world.getCollider(key, isBooster);
+  }
+  PhysicsWorld::UserObject& ballItem = this->items[this->item[i]];
+  isBooster = ballItem.isBooster;
+  if (ballItem.isBooster) {
+    return ballItem.booster;
+  }
+  return ballItem.bouncyObject;
+}
+
+bool BallBatch::isTouching(const size_t i, const size_t key) {
+  const std::vector<size_t>& KEYS = this->touchingKeys[i];
+  return std::find(KEYS.begin(), KEYS.end(), key) != KEYS.end();
+}
+
+bool BallBatch::sweep(const size_t i, float deltaTime) {
+
+  for (unsigned short sweepNr = 0; sweepNr < PhysicsWorld::MAX_SWEEPS && deltaTime > 0; ++sweepNr) {
+
+    // Physics is y-up, SFML is y-down (see Ball::updatePoistion)
+    sf::Vector2f velocity(this->velocityX[i], this->velocityY[i]);
+    const sf::Vector2f VELOCITY = PhysicsObjects::getDirection(velocity) * getLength(velocity);
+    const sf::Vector2f DISPLACEMENT(VELOCITY.x * deltaTime, -VELOCITY.y * deltaTime);
+
+    // Only look at the colliders in the cells that the ball moves through
+    const sf::Vector2f START(this->positionX[i], this->positionY[i]);
+    const sf::Vector2f END = START + DISPLACEMENT;
+    const float RADIUS = this->radius[i];
+    this->world.queryColliders(
+      sf::Vector2f(std::min(START.x, END.x) - RADIUS, std::min(START.y, END.y) - RADIUS),
+      sf::Vector2f(std::max(START.x, END.x) + RADIUS, std::max(START.y, END.y) + RADIUS),
+      this->nearbyKeys
+    );
+
+    float earliest = 2.f;
+    int earliestSide = -1;
+    size_t hitKey = 0;
+
+    float toi;
+    int side;
+    const auto TEST = [&](const size_t KEY) {
+      bool isBooster;
+      PhysicsObjects::BouncyObject& collider = this->getCollider(i, KEY, isBooster);
+      // A booster is not solid. It only boosts the ball once when it enters
+      if (isBooster && this->isTouching(i, KEY)) {
+        return;
+      }
+      if ((side = collider.sweepCircleCollision(START, RADIUS, DISPLACEMENT, toi)) != -1 && toi < earliest) {
+        earliest = toi;
+        earliestSide = side;
+        hitKey = KEY;
+      }
+    };
+    for (const size_t KEY : this->nearbyKeys) {
+      TEST(KEY);
+    }
+    // The ball's own item comes last, like the newest item in the world's sorted keys. The sweep skips it when it's outside of the query area, like the grid would
+    if (this->item[i] != NO_ITEM) {
+      TEST(ITEM_KEY);
+    }
+
+    const float MOVE_TIME = (earliestSide == -1) ? deltaTime : earliest * deltaTime;
+    this->positionX[i] += velocity.x * MOVE_TIME;
+    this->positionY[i] -= velocity.y * MOVE_TIME;
+    if (earliestSide == -1) {
+      return false;
+    }
+    deltaTime *= 1.f - earliest;
+
+    if (!this->isTouching(i, hitKey)) {
+      this->touchingKeys[i].push_back(hitKey);
+    }
+
+    bool isBooster;
+    PhysicsObjects::BouncyObject& hitObject = this->getCollider(i, hitKey, isBooster);
+    if (isBooster) {
+      velocity = static_cast<PhysicsObjects::Booster&>(hitObject).getBoostedVelocity(velocity);
+    } else {
+      velocity = hitObject.getBouncedVelocity(velocity, static_cast<short>(earliestSide));
+    }
+    this->velocityX[i] = velocity.x;
+    this->velocityY[i] = velocity.y;
+
+    // The ball stops right at the surface, so it has come to rest when a bounce leaves it this slow
+    if (!isBooster && getLength(velocity) < PhysicsWorld::REST_VELOCITY) {
+      return true;
+    }
+
+  }
+
+  // Out of sweeps: the ball is stuck in a corner, so it doesn't move for the rest of the step
+  return false;
+
+}
+
+bool BallBatch::checkCollisions(const size_t i) {
+
+  // Stop when the ball has glitched through a wall of the floor and is outside of the level
+  const sf::Vector2f MID(this->positionX[i], this->positionY[i]);
+  const sf::Vector2f LEVEL_SIZE = this->world.getLevelSize();
+  if (MID.x < 0 || MID.x > LEVEL_SIZE.x || MID.y < 0 || MID.y > LEVEL_SIZE.y) {
+    return true;
+  }
+
+  const sf::Vector2f VELOCITY(this->velocityX[i], this->velocityY[i]);
+  const sf::Vector2f DIRECTION = PhysicsObjects::getDirection(VELOCITY);
+
+  std::vector<size_t>& keys = this->touchingKeys[i];
+  for (size_t j = 0; j < keys.size(); ) {
+    bool isBooster;
+    PhysicsObjects::BouncyObject& collider = this->getCollider(i, keys[j], isBooster);
+
+    if (collider.checkCircleCollision(MID, (1.f + PhysicsWorld::CONTACT_SKIN) * this->radius[i], DIRECTION) != -1) {
+      // Stop right before the ball falls through the ground
+      if (!isBooster && getLength(VELOCITY) < PhysicsWorld::REST_VELOCITY) {
+        return true;
+      }
+      ++j;
+      continue;
+    }
+
+    // The ball left the object, so forget it (keeping the order)
+    keys.erase(keys.begin() + static_cast<std::ptrdiff_t>(j));
+  }
+
+  return false;
+
+}
+
+void BallBatch::applyGravity(const size_t i, const float deltaTime) {
+  const float ACCELERATION = (this->mass[i] * (this->world.getUnitSize() * 9.81f)) / this->mass[i];
+  const sf::Vector2f DELTA_VELOCITY = sf::Vector2f(0, -1) * static_cast<float>(ACCELERATION * deltaTime);
+  this->velocityX[i] += DELTA_VELOCITY.x;
+  this->velocityY[i] += DELTA_VELOCITY.y;
+}
+
+bool BallBatch::move(const size_t i, const float deltaTime) {
+  if (this->sweep(i, deltaTime) || this->checkCollisions(i)) {
+    this->finished[i] = true;
+    return false;
+  }
+
+  const float UNIT_SIZE = this->world.getUnitSize();
+  const std::vector<MoneyBagState>& BAGS = this->world.getMoneyBags();
+  for (size_t bag = 0; bag < this->numBags; ++bag) {
+    uint8_t& isCollected = this->collected[i * this->numBags + bag];
+    if (!isCollected && intersectMoneyBag(BAGS[bag].pos, UNIT_SIZE, sf::Vector2f(this->positionX[i], this->positionY[i]), this->radius[i])) {
+      isCollected = true;
+    }
+  }
+  return true;
+}
+
+size_t BallBatch::step(const float deltaTime) {
+
+  // Gravity first, for all of the balls in one go. Finished balls keep their velocity
+  for (size_t i = 0; i < this->size(); ++i) {
+    if (!this->finished[i]) {
+      this->applyGravity(i, deltaTime);
+    }
+  }
+
+  size_t running = 0;
+  for (size_t i = 0; i < this->size(); ++i) {
+    if (!this->finished[i] && this->move(i, deltaTime)) {
+      ++running;
+    }
+  }
+
+  return running;
+
+}
+
+size_t BallBatch::tick(const uint32_t maxTicks) {
+
+  size_t running = 0;
+  for (size_t i = 0; i < this->size(); ++i) {
+
+    if (this->finished[i] || this->ticks[i] >= maxTicks) {
+      continue;
+    }
+    ++this->ticks[i];
+
+    // The same steps as PhysicsWorld::tick
+    float timeLeft = PhysicsWorld::TICK;
+    bool ballRunning = true;
+    while (ballRunning && timeLeft > 0) {
+      const float SUBSTEP = PhysicsWorld::getSubstep(timeLeft, getLength(sf::Vector2f(this->velocityX[i], this->velocityY[i])), this->radius[i]);
+      this->applyGravity(i, SUBSTEP);
+      ballRunning = this->move(i, SUBSTEP);
+      timeLeft -= SUBSTEP;
+    }
+
+    if (ballRunning && this->ticks[i] < maxTicks) {
+      ++running;
+    }
+
+  }
+
+  return running;
+
+}
@@ -21,19 +21,30 @@
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/Sprite.hpp>
 #include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/VertexArray.hpp>
 #include <SFML/System/Angle.hpp>
 #include <SFML/System/Vector2.hpp>
+#include <algorithm>
 #include <filesystem>
 #include <stdexcept>
 #include <string>
 
 #include "../include/physics.hpp"
 #include "../include/globals.hpp"
+#include "../include/render.hpp"
+#include "../include/layers.hpp"
 #include "../include/ui.hpp"
 #include "../include/config.hpp"
+#include "../include/preview.hpp"
+#include "../include/world.hpp"
 
 #define Key sf::Keyboard::Key
 
+// How many ticks of the trajectory preview are simulated per frame. A whole run takes a few frames, but a frame never waits for it
+const size_t PREVIEW_TICKS_PER_FRAME = 400;
+
 UserObjects::GhostObject building{sf::Vector2f(), RESOURCES_PATH, 0};
 
 void UserObjects::initBuilding(const sf::Vector2f newSize, const std::filesystem::path texturePath, const int8_t itemId, const float rotation) {
@@ -44,6 +55,7 @@ void UserObjects::clearBuilding() {
   // This about does the job. Might not be the cleanest way to do it, but at least it doesn't draw a 👻 object
   building.setSize(sf::Vector2f());
   building.setRotation(0);
+  building.getPreview().clear();
 }
 
 UserObjects::GhostObject* UserObjects::getBuilding() {
@@ -54,34 +66,31 @@ UserObjects::GhostObject* UserObjects::getBuilding() {
 // GhostObject
 //////////////////////////////////////
 
-void UserObjects::GhostObject::loop(const bool rotateKeyPressed, Config& playerConf) {
+void UserObjects::GhostObject::loop(const bool rotateKeyPressed, Config& playerConf, PhysicsWorld& world) {
 
   if (rotateKeyPressed) {
     float rotateAngle = 0;
-    if (sf::Keyboard::isKeyPressed(playerConf.getKeybind("ROTATE_CCW"))) {
+    if (Globals::platform->isKeyPressed(playerConf.getKeybind("ROTATE_CCW"))) {
       rotateAngle = -1;
-    } else if (sf::Keyboard::isKeyPressed(playerConf.getKeybind("ROTATE_CW"))) {
+    } else if (Globals::platform->isKeyPressed(playerConf.getKeybind("ROTATE_CW"))) {
       rotateAngle = 1;
     }
-    if (sf::Keyboard::isKeyPressed(playerConf.getKeybind("ROTATE_SMALL"))) {
+    if (Globals::platform->isKeyPressed(playerConf.getKeybind("ROTATE_SMALL"))) {
       rotateAngle /= 5;
-    } else if (sf::Keyboard::isKeyPressed(playerConf.getKeybind("ROTATE_BIG"))) {
+    } else if (Globals::platform->isKeyPressed(playerConf.getKeybind("ROTATE_BIG"))) {
       rotateAngle *= 3;
     }
     this->rotation += rotateAngle;
   }
 
   // Place the points to match the orientation and position
-  sf::Vector2i mousePos = sf::Mouse::getPosition(*Globals::window);
+  sf::Vector2i mousePos = Globals::platform->getMousePosition();
   
-  sf::Texture ghostTexture;
-  if (!ghostTexture.loadFromFile(this->texturePath)) {
-    throw std::runtime_error("Couldn't load the ghost sprite texture.");
-  }
-  ghostTexture.setSmooth(true);
-  sf::Vector2f ghostTextureSize = static_cast<sf::Vector2f>(ghostTexture.getSize());
+  // Only loaded the first time, every other frame gets it from the cache
+  const SpriteRegion GHOST_SPRITE = Globals::getResources().getSprite(this->texturePath, true);
+  sf::Vector2f ghostTextureSize = GHOST_SPRITE.getSize();
 
-  sf::Sprite ghostSprite(ghostTexture);
+  sf::Sprite ghostSprite(*GHOST_SPRITE.texture, GHOST_SPRITE.rect);
   ghostSprite.setOrigin(0.5f * ghostTextureSize);
   ghostSprite.setRotation(sf::degrees(this->rotation));
   ghostSprite.setScale(sf::Vector2f((this->size.x * Globals::unitSize) / ghostTextureSize.x, (this->size.y * Globals::unitSize) / ghostTextureSize.y));
@@ -90,7 +99,20 @@ void UserObjects::GhostObject::loop(const bool rotateKeyPressed, Config& playerC
   // Set the ghost sprite to be transparent
   ghostSprite.setColor(sf::Color(255, 255, 255, 200));
 
-  Globals::window->draw(ghostSprite);
+  // Predict where the ball goes with the object placed here. This restarts when the object moves or rotates,
+  // and continues where it left off in the next frame
+  this->preview.update(world, {this->itemID, mousePos, this->rotation});
+  this->preview.advance(PREVIEW_TICKS_PER_FRAME);
+
+  const std::vector<sf::Vector2f>& PATH = this->preview.getPoints();
+  sf::VertexArray pathLine(sf::PrimitiveType::LineStrip, PATH.size());
+  for (size_t i = 0; i < PATH.size(); ++i) {
+    pathLine[i].position = PATH[i];
+    pathLine[i].color = sf::Color(255, 255, 255, 150);
+  }
+  Globals::renderQueue.submit(RenderQueue::WORLD, pathLine);
+
+  Globals::renderQueue.submit(RenderQueue::WORLD, GHOST_SPRITE, ghostSprite.getTransform(), ghostSprite.getColor());
 
 }
 
@@ -102,7 +124,7 @@ void UserObjects::GhostObject::place(UserObjects::EditableObjectList& objList, U
 
   const bool BOOSTER = this->texturePath.filename() == "booster.png";
 
-  objList.addObject(new UserObjects::EditableObject(sf::Mouse::getPosition(*Globals::window), this->size, this->texturePath, this->itemID, this->rotation, BOUNCY, (this->texturePath.filename() == "bouncePad.png") ? 0.95f : 0.8f, BOOSTER));
+  objList.addObject(new UserObjects::EditableObject(Globals::platform->getMousePosition(), this->size, this->texturePath, this->itemID, this->rotation, BOUNCY, (this->texturePath.filename() == "bouncePad.png") ? 0.95f : 0.8f, BOOSTER));
   clearBuilding();
 }
 
@@ -111,36 +133,13 @@ void UserObjects::GhostObject::place(UserObjects::EditableObjectList& objList, U
 //////////////////////////////////////
 
 UserObjects::EditableObject::EditableObject(const sf::Vector2i newPos, const sf::Vector2f newSize, const std::filesystem::path newTexturePath, const int8_t itemId, const float newRotation, const bool bouncy, const float cor, const bool booster) 
-: itemID(itemId), pos(newPos), size(newSize), texturePath(newTexturePath), rotation(newRotation), bouncyObject(bouncy), cor(cor), booster(booster) {
-  // Load the texture and store it
-  if (!this->texture.loadFromFile(newTexturePath)) {
-    throw std::runtime_error("Couldn't load the EditableObject's texture.");
-  }
-  this->texture.setSmooth(true);
+: itemID(itemId), pos(newPos), size(newSize), texturePath(newTexturePath), sprite(Globals::getResources().getSprite(newTexturePath, true)), rotation(newRotation), bouncyObject(bouncy), cor(cor), booster(booster) {
 
   if (bouncy) {
-    this->bo = PhysicsObjects::BouncyObject();
-    this->bo.setCOR(cor);
-    this->bo.setOrientation(sf::Vector2f(1,0).rotatedBy(sf::degrees(90.f - newRotation)));
-
-    // For the points of the BouncyObject I use a RectangleShape and get its points
-    sf::RectangleShape rect(newSize * Globals::unitSize);
-    rect.setOrigin(0.5f * Globals::unitSize * newSize);
-    rect.setRotation(sf::degrees(newRotation));
-    rect.setPosition(static_cast<sf::Vector2f>(newPos));
-    sf::Transform transform = rect.getTransform();
-    // transform.translate(static_cast<sf::Vector2f>(this->pos) + 0.5f * (this->size * unitSize))
-    //          .rotate(sf::degrees(this->rotation))
-    //          .scale(sf::Vector2f((this->size.x * unitSize) / this->texture.getSize().x, (this->size.y * unitSize) / this->texture.getSize().y));
-    this->bo.setPoints({
-      transform.transformPoint(rect.getPoint(1)),
-      transform.transformPoint(rect.getPoint(2)),
-      transform.transformPoint(rect.getPoint(3)),
-      transform.transformPoint(rect.getPoint(0))
-    });
+    this->bo = PhysicsObjects::makeBouncePad(newPos, newSize, newRotation, Globals::unitSize, cor);
   }
   if (booster) {
-    this->boost = PhysicsObjects::Booster(newPos, newSize, newRotation, 0.3f);
+    this->boost = PhysicsObjects::Booster(newPos, newSize, newRotation, Globals::unitSize, 0.3f);
   }
 };
 
@@ -156,15 +155,15 @@ bool UserObjects::EditableObject::intersect(const sf::Vector2i position) {
   return rectBounds.contains(static_cast<sf::Vector2f>(position));
 }
 
-void UserObjects::EditableObject::draw() {
-  sf::Sprite objSprite(this->texture);
-  objSprite.setOrigin(0.5f * static_cast<sf::Vector2f>(this->texture.getSize()));
-  objSprite.setScale(sf::Vector2f((this->size.x * Globals::unitSize) / static_cast<float>(this->texture.getSize().x), (this->size.y * Globals::unitSize) / static_cast<float>(this->texture.getSize().y)));
+void UserObjects::EditableObject::draw(RenderQueue& queue) {
+  sf::Sprite objSprite(*this->sprite.texture, this->sprite.rect);
+  objSprite.setOrigin(0.5f * this->sprite.getSize());
+  objSprite.setScale(sf::Vector2f((this->size.x * Globals::unitSize) / this->sprite.getSize().x, (this->size.y * Globals::unitSize) / this->sprite.getSize().y));
   // The `+ 0.5f * this->size` can't be added when the object is created, because otherwise when editing its position will be wrong
   objSprite.setPosition(static_cast<sf::Vector2f>(this->pos) + 0.5f * this->size);
   objSprite.setRotation(sf::degrees(this->rotation));
 
-  Globals::window->draw(objSprite);
+  queue.submit(RenderQueue::WORLD, this->sprite, objSprite.getTransform());
 }
 
 //////////////////////////////////////
@@ -175,4 +174,41 @@ UserObjects::EditableObjectList::~EditableObjectList() {
   for (UserObjects::EditableObject* pObj : this->editableObjects) {
     delete pObj;
   }
+}
+
+void UserObjects::EditableObjectList::addObject(UserObjects::EditableObject* object) {
+  this->editableObjects.push_back(object);
+  Globals::layers.invalidate(SceneLayers::FOREGROUND);
+
+  if (this->world == nullptr) return;
+  if (object->hasBouncyObject()) {
+    object->setWorldId(this->world->addBouncyObject(object->getBouncyObject()));
+  } else if (object->hasBooster()) {
+    object->setWorldId(this->world->addBooster(object->getBooster()));
+  }
+}
+
+void UserObjects::EditableObjectList::removeObject(UserObjects::EditableObject* object) {
+  std::vector<UserObjects::EditableObject*>::iterator it;
+  if ((it = std::find(this->editableObjects.begin(), this->editableObjects.end(), object)) == this->editableObjects.end()) {
+    return;
+  }
+
+  if (this->world != nullptr && (object->hasBouncyObject() || object->hasBooster())) {
+    this->world->removeUserObject(object->getWorldId());
+  }
+
+  delete *it;
+  this->editableObjects.erase(it);
+  Globals::layers.invalidate(SceneLayers::FOREGROUND);
+}
+
+void UserObjects::EditableObjectList::clear() {
+  for (UserObjects::EditableObject* pObj : this->editableObjects) {
+    delete pObj;
+  }
+  this->editableObjects.clear();
+  Globals::layers.invalidate(SceneLayers::FOREGROUND);
+
+  if (this->world != nullptr) this->world->clearUserObjects();
 }
\ No newline at end of file
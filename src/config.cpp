@@ -17,10 +17,17 @@
 #include <fstream>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "../include/config.hpp"
 
+// The keybinds that were added after the first config files were made. A config file without them gets these
+const std::pair<const char*, sf::Keyboard::Scan> DEFAULT_KEYBINDS[] = {
+  {"TIME_SCALE", sf::Keyboard::Scan::Space},
+  {"SAVE_TRACE", sf::Keyboard::Scan::F12}
+};
+
 void Config::loadFromFile(const std::filesystem::path configFile) {
 
   this->loadedConfigFile = configFile;
@@ -58,6 +65,10 @@ void Config::loadFromFile(const std::filesystem::path configFile) {
     this->keybinds.emplace(linestr.substr(0, spacePos), static_cast<sf::Keyboard::Scan>(std::stoi(linestr.substr(spacePos + 1))));
   }
 
+  for (const auto& [name, keybind] : DEFAULT_KEYBINDS) {
+    this->keybinds.emplace(name, keybind);
+  }
+
   for (auto& [name, keybind] : this->keybinds) {
     std::clog << name << " is set to " << sf::Keyboard::getDescription(keybind).toAnsiString() << std::endl;
   }
@@ -75,15 +86,32 @@ void Config::setKeybind(const std::string name, const sf::Keyboard::Scan value)
 
   std::vector<std::string> lines;
   std::string linestr;
+  bool found = false;
 
   while (std::getline(fileStream, linestr)) {
     if (linestr.find(name) != std::string::npos) {
       linestr = name + ' ' + std::to_string(static_cast<int>(value));
+      found = true;
     }
     lines.push_back(linestr);
   }
   fileStream.close();
 
+  // A keybind that came from DEFAULT_KEYBINDS isn't in the file yet. Add it at the end of the [Keybinds]
+  if (!found) {
+    size_t insertAt = lines.size();
+    bool inKeybinds = false;
+    for (size_t i = 0; i < lines.size(); ++i) {
+      if (lines[i].find("[Keybinds]") != std::string::npos) {
+        inKeybinds = true;
+      } else if (inKeybinds && lines[i].empty()) {
+        insertAt = i;
+        break;
+      }
+    }
+    lines.insert(lines.begin() + static_cast<std::ptrdiff_t>(insertAt), name + ' ' + std::to_string(static_cast<int>(value)));
+  }
+
   std::ofstream outFile;
   outFile.open(this->loadedConfigFile);
 
@@ -21,6 +21,7 @@
 #include <filesystem>
 #include <fstream>
 #include <ios>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -30,6 +31,7 @@
 #include "../include/dialogue.hpp"
 #include "../include/ui.hpp"
 #include "../include/globals.hpp"
+#include "../include/render.hpp"
 #include "../include/audio.hpp"
 
 //////////////////////////////////////
@@ -37,7 +39,7 @@
 //////////////////////////////////////
 
 TextBubble::TextBubble(const std::string text) :
-UIElements::TextLabel(text, sf::Vector2f(0.5f * Globals::window->getSize().x, 14.f * Globals::unitSize), sf::Vector2f(12.f * Globals::unitSize, 2.f * Globals::unitSize), std::filesystem::path(RESOURCES_PATH).append("sprites/blank.png"), sf::Color::White, Globals::monoFont) {
+UIElements::TextLabel(text, sf::Vector2f(0.5f * Globals::platform->getSize().x, 14.f * Globals::unitSize), sf::Vector2f(12.f * Globals::unitSize, 2.f * Globals::unitSize), std::filesystem::path(RESOURCES_PATH).append("sprites/blank.png"), sf::Color::White, Globals::getMonoFont()) {
   this->message = text;
 }
 
@@ -58,11 +60,8 @@ void TextBubble::typewriterText() {
   this->setText("", true);
   uint8_t currLine = 0;
 
-  sf::SoundBuffer keyPressSound;
-
-  if (!keyPressSound.loadFromFile(std::filesystem::path(RESOURCES_PATH).append("audio/key.wav"))) {
-    throw std::runtime_error("Couldn't load the key sound.");
-  }
+  // The AudioEngine shares it with the voices that still play it after this function has returned
+  const SoundBufferHandle keyPressSound = Globals::getResources().getSoundBuffer(std::filesystem::path(RESOURCES_PATH).append("audio/key.wav"));
 
   for (char character : this->message) {
 
@@ -78,8 +77,7 @@ void TextBubble::typewriterText() {
 
     this->setText(current + std::string(NUM_SPACES, ' ') + std::string(lines - (currLine + 1), '\n'), true);
 
-    Globals::threads.emplace_back(playSound, keyPressSound);
-    Globals::threads.back().detach();
+    Globals::platform->playSound(keyPressSound);
 
     sf::sleep(sf::milliseconds(50));
   }
@@ -91,24 +89,20 @@ void TextBubble::draw() {
   }
 
   // Draw background
-  sf::Texture backgrTexture;
-  if (!backgrTexture.loadFromFile(std::filesystem::path(RESOURCES_PATH).append("sprites/dialogueBackground.png"))) {
-    throw std::runtime_error("Couldn't load the dialogue background sprite.");
-  }
-  backgrTexture.setSmooth(true);
+  const SpriteRegion BACKGR_SPRITE = Globals::getResources().getSprite(std::filesystem::path(RESOURCES_PATH).append("sprites/dialogueBackground.png"), true);
 
-  sf::Sprite backgrSprite{backgrTexture};
-  backgrSprite.setOrigin(sf::Vector2f(0.5f * backgrTexture.getSize().x, 0));
-  backgrSprite.setScale(sf::Vector2f(12.f * Globals::unitSize / backgrTexture.getSize().x, 2.f * Globals::unitSize / backgrTexture.getSize().y));
-  backgrSprite.setPosition(sf::Vector2f(0.5f * Globals::window->getSize().x, 14.f * Globals::unitSize));
+  sf::Sprite backgrSprite{*BACKGR_SPRITE.texture, BACKGR_SPRITE.rect};
+  backgrSprite.setOrigin(sf::Vector2f(0.5f * BACKGR_SPRITE.getSize().x, 0));
+  backgrSprite.setScale(sf::Vector2f(12.f * Globals::unitSize / BACKGR_SPRITE.getSize().x, 2.f * Globals::unitSize / BACKGR_SPRITE.getSize().y));
+  backgrSprite.setPosition(sf::Vector2f(0.5f * Globals::platform->getSize().x, 14.f * Globals::unitSize));
 
-  Globals::window->draw(backgrSprite);
+  Globals::renderQueue.submit(RenderQueue::POPUP, BACKGR_SPRITE, backgrSprite.getTransform());
 
   // Draw text
   // Magic number time
-  this->setPos(sf::Vector2f(0.5f * Globals::window->getSize().x + .5f * Globals::unitSize, 15.f * Globals::unitSize));
+  this->setPos(sf::Vector2f(0.5f * Globals::platform->getSize().x + .5f * Globals::unitSize, 15.f * Globals::unitSize));
   this->setSize(sf::Vector2f(12.f * Globals::unitSize, 2.2f * Globals::unitSize));
-  static_cast<UIElements::TextLabel*>(this)->draw();
+  static_cast<UIElements::TextLabel*>(this)->draw(RenderQueue::POPUP);
 }
 
 //////////////////////////////////////
@@ -11,27 +11,33 @@
 
 #include "../include/globals.hpp"
 
-#include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/Font.hpp>
 #include <filesystem>
-#include <stdexcept>
 #include <thread>
 #include <vector>
 
-sf::Font Globals::mainFont;
-sf::Font Globals::monoFont;
+const sf::Font& Globals::getMainFont() {
+  // The handle keeps the font alive until the end of the game, also when the cache gets cleared
+  static const FontHandle FONT = getResources().getFont(std::filesystem::path(RESOURCES_PATH).append("font/NotoSans-Regular.ttf"));
+  return *FONT;
+}
+
+const sf::Font& Globals::getMonoFont() {
+  static const FontHandle FONT = getResources().getFont(std::filesystem::path(RESOURCES_PATH).append("font/NotoSansMono-Regular.ttf"));
+  return *FONT;
+}
 
 void Globals::initFont() {
-  std::filesystem::path fontPath = std::filesystem::path(RESOURCES_PATH).append("font/NotoSans-Regular.ttf");
-  if (!mainFont.loadFromFile(fontPath)) {
-    throw std::runtime_error("Couldn't load the font. Did you set the hardcoded variable right?");
-  }
-  if (!monoFont.loadFromFile(std::filesystem::path(RESOURCES_PATH).append("font/NotoSansMono-Regular.ttf"))) {
-    throw std::runtime_error("Couldn't load the monospace font. Did you set the hardcoded variable right?");
-  }
+  getMainFont();
+  getMonoFont();
+}
+
+ResourceCache& Globals::getResources() {
+  static ResourceCache resources;
+  return resources;
 }
 
-sf::RenderWindow* Globals::window;
+Platform* Globals::platform;
 float Globals::unitSize;
 
 bool Globals::simulationOn = false;
@@ -46,4 +52,10 @@ float Globals::volume = 100;
 
 std::vector<std::thread> Globals::threads;
 
+AudioEngine Globals::audio;
+
+SceneLayers Globals::layers;
+
+RenderQueue Globals::renderQueue;
+
 bool Globals::DEBUG_MODE = false;
\ No newline at end of file
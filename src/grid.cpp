@@ -0,0 +1,80 @@
+/**
+ * @file grid.cpp
+ * @author Patrick Vreeburg
+ * @brief The broadphase of the physics
+ * @version 0.1
+ * @date 2024-05-19
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "../include/grid.hpp"
+
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+CollisionGrid::CollisionGrid(const float newCellSize, const sf::Vector2f levelSize) : cellSize(newCellSize) {
+  this->gridSize.x = std::max(1u, static_cast<unsigned int>(std::ceil(levelSize.x / newCellSize)));
+  this->gridSize.y = std::max(1u, static_cast<unsigned int>(std::ceil(levelSize.y / newCellSize)));
+  this->cells.resize(this->gridSize.x * this->gridSize.y);
+}
+
+void CollisionGrid::getCellRange(const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax, sf::Vector2u& first, sf::Vector2u& last) {
+  // Clamp to the edges, so the walls (which stick out of the level) and a ball that flew off still end up in a cell
+  auto toCell = [this](const float coordinate, const unsigned int cellCount) {
+    const float CELL = std::floor(coordinate / this->cellSize);
+    if (CELL < 0) return 0u;
+    if (CELL >= static_cast<float>(cellCount)) return cellCount - 1;
+    return static_cast<unsigned int>(CELL);
+  };
+  first = sf::Vector2u(toCell(boundsMin.x, this->gridSize.x), toCell(boundsMin.y, this->gridSize.y));
+  last = sf::Vector2u(toCell(boundsMax.x, this->gridSize.x), toCell(boundsMax.y, this->gridSize.y));
+}
+
+void CollisionGrid::insert(const size_t key, const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax) {
+  sf::Vector2u first, last;
+  this->getCellRange(boundsMin, boundsMax, first, last);
+  for (unsigned int y = first.y; y <= last.y; ++y) {
+    for (unsigned int x = first.x; x <= last.x; ++x) {
+      this->cells[y * this->gridSize.x + x].push_back(key);
+    }
+  }
+}
+
+void CollisionGrid::remove(const size_t key, const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax) {
+  sf::Vector2u first, last;
+  this->getCellRange(boundsMin, boundsMax, first, last);
+  for (unsigned int y = first.y; y <= last.y; ++y) {
+    for (unsigned int x = first.x; x <= last.x; ++x) {
+      std::vector<size_t>& cell = this->cells[y * this->gridSize.x + x];
+      cell.erase(std::remove(cell.begin(), cell.end(), key), cell.end());
+    }
+  }
+}
+
+void CollisionGrid::clear() {
+  for (std::vector<size_t>& cell : this->cells) {
+    cell.clear();
+  }
+}
+
+void CollisionGrid::query(const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax, std::vector<size_t>& keys) {
+  keys.clear();
+
+  sf::Vector2u first, last;
+  this->getCellRange(boundsMin, boundsMax, first, last);
+  for (unsigned int y = first.y; y <= last.y; ++y) {
+    for (unsigned int x = first.x; x <= last.x; ++x) {
+      const std::vector<size_t>& cell = this->cells[y * this->gridSize.x + x];
+      keys.insert(keys.end(), cell.begin(), cell.end());
+    }
+  }
+
+  // A big collider is in more than one cell. Sorting also keeps the order the same as a plain loop over all colliders
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+}
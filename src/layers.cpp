@@ -0,0 +1,61 @@
+/**
+ * @file layers.cpp
+ * @author Patrick Vreeburg
+ * @brief Caches the parts of the level that don't change every frame
+ * @version 0.1
+ * @date 2024-07-28
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "../include/layers.hpp"
+
+#include <SFML/Graphics/BlendMode.hpp>
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/RenderTexture.hpp>
+#include <SFML/Graphics/Sprite.hpp>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+
+//////////////////////////////////////
+// SceneLayers
+//////////////////////////////////////
+
+void SceneLayers::invalidateAll() {
+  for (Cache& cache : this->caches) {
+    cache.dirty = true;
+  }
+}
+
+void SceneLayers::draw(sf::RenderTarget& target, const Layer layer, const std::function<void(sf::RenderTarget&)>& drawContent) {
+  if (!this->enabled) {
+    drawContent(target);
+    return;
+  }
+
+  Cache& cache = this->caches[layer];
+
+  if (cache.texture == nullptr || cache.texture->getSize() != target.getSize()) {
+    cache.texture = std::make_unique<sf::RenderTexture>();
+    if (!cache.texture->create(target.getSize())) {
+      throw std::runtime_error("Couldn't create the render texture of a scene layer.");
+    }
+    cache.dirty = true;
+  }
+
+  if (cache.dirty) {
+    cache.texture->clear(sf::Color::Transparent);
+    drawContent(*cache.texture);
+    cache.texture->display();
+    cache.dirty = false;
+  }
+
+  // The contents were blended onto a transparent texture, so its colors are already multiplied by their alpha.
+  // Blending them with BlendAlpha again would multiply them twice and darken the antialiased and see-through edges
+  const sf::BlendMode PREMULTIPLIED_ALPHA(sf::BlendMode::One, sf::BlendMode::OneMinusSrcAlpha);
+  target.draw(sf::Sprite(cache.texture->getTexture()), sf::RenderStates(PREMULTIPLIED_ALPHA));
+}
@@ -0,0 +1,170 @@
+/**
+ * @file level_data.cpp
+ * @author Patrick Vreeburg
+ * @brief Reads the level files
+ * @version 0.1
+ * @date 2024-07-31
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "../include/level_data.hpp"
+
+#include <SFML/System/Vector2.hpp>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "../include/profiler.hpp"
+
+/**
+ * @brief Reads the number at the start of the text, after the spaces, brackets and commas in front of it, and moves the text past it
+ *
+ * @param text The rest of the line
+ * @param value Gets the number
+ * @param base The base of an integer. The tilemap is in base 36
+ * @return true if there was a number
+ */
+template <typename T>
+bool readLevelNumber(std::string_view& text, T& value, const int base = 10) {
+  const size_t START = text.find_first_not_of(" \t(),");
+  if (START == std::string_view::npos) return false;
+  text.remove_prefix(START);
+
+  std::from_chars_result result;
+  if constexpr (std::is_integral_v<T>) {
+    result = std::from_chars(text.data(), text.data() + text.size(), value, base);
+  } else {
+    result = std::from_chars(text.data(), text.data() + text.size(), value);
+  }
+  if (result.ec != std::errc()) return false;
+  text.remove_prefix(static_cast<size_t>(result.ptr - text.data()));
+  return true;
+}
+
+void parseLevelData(std::string_view text, LevelData& data) {
+  enum class Section {NONE, TILEMAP, INVENTORY, MONEY_BAGS_NEEDED, BOUNCY_OBJECTS, MONEY_BAGS};
+
+  Section section = Section::NONE;
+  unsigned short row = 0;
+
+  while (!text.empty()) {
+    const size_t END = text.find('\n');
+    std::string_view line = text.substr(0, END);
+    text.remove_prefix((END == std::string_view::npos) ? text.size() : END + 1);
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+    if (!line.empty() && line.front() == '[') {
+      section = Section::NONE;
+      if (line == "[Tilemap]") {
+        section = Section::TILEMAP;
+        row = 0;
+      } else if (line == "[Inventory]") {
+        section = Section::INVENTORY;
+        data.inventory.clear();
+      } else if (line == "[MoneyBagsNeeded]") {
+        section = Section::MONEY_BAGS_NEEDED;
+      } else if (line == "[BouncyObjects]") {
+        section = Section::BOUNCY_OBJECTS;
+        data.colliders.clear();
+      } else if (line == "[MoneyBags]") {
+        section = Section::MONEY_BAGS;
+        data.moneyBags.clear();
+      }
+      continue;
+    }
+    // Every section ends at an empty line
+    if (line.find_first_not_of(" \t") == std::string_view::npos) {
+      section = Section::NONE;
+      continue;
+    }
+
+    std::string_view rest = line;
+    bool valid = true;
+    switch (section) {
+
+      case Section::NONE:
+        break;
+
+      case Section::TILEMAP:
+        if (row >= TILEMAP_SIZE) break;
+        for (unsigned short column = 0; column < TILEMAP_SIZE && valid; ++column) {
+          valid = readLevelNumber(rest, data.tilemap[row][column], 36);
+        }
+        ++row;
+        break;
+
+      case Section::INVENTORY: {
+        int itemId, count;
+        valid = readLevelNumber(rest, itemId) && readLevelNumber(rest, count);
+        data.inventory.push_back({static_cast<int8_t>(itemId), static_cast<int16_t>(count)});
+        break;
+      }
+
+      case Section::MONEY_BAGS_NEEDED: {
+        unsigned needed;
+        valid = readLevelNumber(rest, needed);
+        data.moneyBagsNeeded = static_cast<uint8_t>(needed);
+        // Only the first line counts
+        section = Section::NONE;
+        break;
+      }
+
+      case Section::BOUNCY_OBJECTS: {
+        LevelData::Collider collider;
+        valid = readLevelNumber(rest, collider.start.x) && readLevelNumber(rest, collider.start.y)
+          && readLevelNumber(rest, collider.end.x) && readLevelNumber(rest, collider.end.y)
+          && readLevelNumber(rest, collider.cor)
+          && readLevelNumber(rest, collider.orientation.x) && readLevelNumber(rest, collider.orientation.y);
+        data.colliders.push_back(collider);
+        break;
+      }
+
+      case Section::MONEY_BAGS: {
+        sf::Vector2f pos;
+        valid = readLevelNumber(rest, pos.x) && readLevelNumber(rest, pos.y);
+        data.moneyBags.push_back(pos);
+        break;
+      }
+
+    }
+
+    if (!valid) {
+      throw std::runtime_error("Invalid line in the level file: " + std::string(line));
+    }
+  }
+}
+
+LevelDataHandle loadLevelData(const std::filesystem::path path) {
+  PROFILE_SCOPE("loadLevelData");
+
+  std::ifstream file;
+  file.open(path, std::ios::in | std::ios::binary);
+
+  if (!file.is_open()) {
+    throw std::runtime_error("Couldn't open the level file " + path.string() + ".");
+  }
+
+  // The whole file at once. The parser only looks at it, it doesn't copy the lines
+  std::ostringstream contents;
+  contents << file.rdbuf();
+
+  std::shared_ptr<LevelData> data = std::make_shared<LevelData>();
+  try {
+    parseLevelData(contents.str(), *data);
+  } catch (const std::runtime_error& e) {
+    throw std::runtime_error(path.string() + ": " + e.what());
+  }
+  return data;
+}
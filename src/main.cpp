@@ -14,6 +14,7 @@
 #include <SFML/Window/Event.hpp>
 #include <SFML/Window/Mouse.hpp>
 #include <SFML/Window/Keyboard.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
 #include <SFML/Graphics/RenderWindow.hpp>
 #include <SFML/Graphics/CircleShape.hpp>
 #include <SFML/Graphics/RectangleShape.hpp>
@@ -30,18 +31,28 @@
 #include <functional>
 #include <stdexcept>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "../include/physics.hpp"
+#include "../include/world.hpp"
 #include "../include/level.hpp"
 #include "../include/ui.hpp"
 #include "../include/build.hpp"
 #include "../include/globals.hpp"
+#include "../include/render.hpp"
+#include "../include/layers.hpp"
 #include "../include/dialogue.hpp"
 #include "../include/config.hpp"
 #include "../include/main_menu.hpp"
 #include "../include/audio.hpp"
+#include "../include/replay.hpp"
+#include "../include/resources.hpp"
+#include "../include/platform.hpp"
+#include "../include/pool.hpp"
+#include "../include/profiler.hpp"
 #include "SFML/Audio/Sound.hpp"
 
 //////////////////////////////////////
@@ -51,7 +62,12 @@
 #define Key sf::Keyboard::Key
 
 const float WINDOW_SIZE_FACTOR = 0.9f;
-const short NULL_VALUE = -1;
+// The size of the window of a headless run: the one the game gets on a 1080p screen
+const sf::Vector2u HEADLESS_WINDOW_SIZE(972, 972);
+// The time step of every frame of a headless run (60 fps)
+const float HEADLESS_DELTA_TIME = 1.f / 60.f;
+// A frame that takes longer than this (in milliseconds) is a hitch and gets its trace saved (see Profiler::endFrame)
+const float DEFAULT_FRAME_BUDGET = 50.f;
 
 float unitSize = 80.f; // The conversion factor from SFML coordinates to meters
 
@@ -60,15 +76,16 @@ sf::Vector2u windowSize;
 // Ball origin
 sf::Vector2f ballOrigin;
 
-// Textures
-sf::Texture wallsTexture;
-sf::Texture propsTexture;
-sf::Texture pipesTexture;
+// Textures. They come from the ResourceCache once the assets are loaded
+TextureHandle wallsTexture;
+TextureHandle propsTexture;
+TextureHandle pipesTexture;
 
-sf::Texture backgroundTexture;
+SpriteRegion backgroundRegion;
 
-// Background sprite
-sf::Sprite backgroundSprite(backgroundTexture);
+// Background sprite. Gets the background texture in main()
+sf::Texture noTexture;
+sf::Sprite backgroundSprite(noTexture);
 
 // Things that the player can click on
 UserObjects::EditableObjectList editableObjects;
@@ -95,37 +112,158 @@ short renderedLevel = -2;
 // before the dialogue is finished.
 bool levelCompleted = false;
 
-// Ball bounce buffers
-sf::SoundBuffer bouncePadBuffer, bounceWallBuffer;
+// Ball bounce and boost buffers. Shared with the AudioEngine while a sound plays
+SoundBufferHandle bouncePadBuffer;
+SoundBufferHandle bounceWallBuffer;
+SoundBufferHandle boostBuffer;
+SoundBufferHandle boostSlowerBuffer;
+
+// The assets that are loaded in parallel before the first frame. The bool is whether the texture is smooth.
+// Anything that isn't in here still works, it's just loaded on the main thread when it's first used
+const std::pair<const char*, bool> PRELOAD_TEXTURES[] = {
+  {"sprites/ball.png", true},
+  {"sprites/itemBackground.png", true},
+  {"sprites/tilemapWall.png", true},
+  {"sprites/tilemapProps.png", true},
+  {"sprites/tilemapPipes.png", true},
+  {"sprites/background.png", true},
+  {"sprites/dialogueBackground.png", true},
+  {"sprites/bouncePad.png", true},
+  {"sprites/booster.png", true},
+  {"sprites/bouncePad.png", false},
+  {"sprites/booster.png", false},
+  {"sprites/blank.png", false},
+  {"sprites/genericButtonBackground.png", false},
+  {"sprites/title.png", false},
+  {"sprites/scoreLabelBackground.png", false},
+  {"sprites/runButtonBackground.png", false},
+  {"sprites/moneyBag.png", false},
+  {"sprites/quasarLogo.png", false},
+  {"sprites/BUasLogo.png", false}
+};
+const char* const PRELOAD_SOUNDS[] = {
+  "audio/bounce_pad.wav",
+  "audio/bounce_wall.wav",
+  "audio/boost.wav",
+  "audio/slower.wav",
+  "audio/key.wav"
+};
+
+// The time scales that the TIME_SCALE keybind cycles through. 0 skips to the result
+const unsigned short TIME_SCALES[] = {1, 2, 8, 0};
+const unsigned short NUM_TIME_SCALES = 4;
+unsigned short timeScaleIndex = 0;
+// Skipping to the result simulates at most this many seconds per frame, in case the ball never comes to rest
+const float MAX_SKIP_TIME = 120.f;
+// The physics moves forward in ticks of PhysicsWorld::TICK, no matter the frame rate, so a run ends the same way on every screen.
+// A frame simulates at most this many ticks per time scale (a quarter of a second). After a hitch, the time that is left over gets dropped,
+// so the frames after it don't get slower and slower trying to catch up
+const unsigned short MAX_CATCH_UP_TICKS = 30;
+// The game time that hasn't been simulated yet. Less than a tick after every frame
+float physicsAccumulator = 0.f;
+// Where the ball was before the last tick. It gets drawn between there and where it is now, renderAlpha of the way
+sf::Vector2f previousBallPosition;
+float renderAlpha = 1.f;
+UIElements::TextLabel timeScaleLabel;
+
+// The recording of the current run. It gets saved to DATA_PATH/replays/lastRun.qr when the run ends
+Replay replay;
+bool recording = false;
 
 //////////////////////////////////////
 // Functions
 //////////////////////////////////////
 
-// Ball-related functions
+// Simulation-related functions
 
-void applyForces(PhysicsObjects::Ball& ball, float deltaTime) {
-  ball.applyForce(deltaTime, ball.getMass() * (unitSize * 9.81f), {0,-1});
+void handleWorldEvents(PhysicsWorld& world, Level& level, const unsigned windowHeight, const bool playSounds) {
+  // Play the sounds and make the collected money bags fall
+  for (PhysicsWorld::Event& event : world.getEvents()) {
+    if (!playSounds && event.type != PhysicsWorld::EventType::MONEY_BAG) continue;
 
-  ball.updatePoistion(deltaTime);
-}
+    switch (event.type) {
+
+      case PhysicsWorld::EventType::BOUNCE_PAD:
+        Globals::platform->playSound(bouncePadBuffer);
+        break;
+
+      case PhysicsWorld::EventType::BOUNCE_WALL:
+        Globals::platform->playSound(bounceWallBuffer);
+        break;
+
+      case PhysicsWorld::EventType::BOOST_FASTER:
+        Globals::platform->playSound(boostBuffer);
+        break;
+
+      case PhysicsWorld::EventType::BOOST_SLOWER:
+        Globals::platform->playSound(boostSlowerBuffer);
+        break;
+
+      case PhysicsWorld::EventType::MONEY_BAG: {
+        MoneyBag* bag = level.getMoneyBags()[event.index];
+        bag->setCollected(true);
+        level.getScoreLabel().setScore(level.getScoreLabel().getScore() + bag->getValue());
+
+        Globals::threads.emplace_back(std::bind(&MoneyBag::fall, bag, world.getBall(), windowHeight));
+        Globals::threads.back().detach();
+        break;
+      }
 
-void checkCollision(PhysicsObjects::BouncyObject& object, PhysicsObjects::Ball& ball) {
-  short collisionSide = static_cast<short>(object.checkBallCollision(ball));
-  if (object.getJustBounced() != collisionSide && collisionSide != NULL_VALUE) {
-    if (object.getCOR() == 0.95f) {
-      // Bounce pad
-      Globals::threads.emplace_back(playSound, bouncePadBuffer);
-      Globals::threads.back().detach();
-    } else {
-      // Walls
-      Globals::threads.emplace_back(playSound, bounceWallBuffer);
-      Globals::threads.back().detach();
     }
-    object.bounce(ball, collisionSide);
-  } else if (object.getJustBounced() != NULL_VALUE && collisionSide == NULL_VALUE) {
-    // This prevents the ball from inevitably staying in the first object it made contact with
-    object.setJustBounced(NULL_VALUE);
+  }
+  world.clearEvents();
+}
+
+void startRecording(PhysicsWorld& world, Level& level) {
+  std::vector<Placement> placements;
+  for (UserObjects::EditableObject* obj : editableObjects.getObjects()) {
+    placements.push_back({obj->getItemId(), obj->getPos(), obj->getRotation()});
+  }
+  replay.start(level.getLevelFilePath(), world, placements);
+  recording = true;
+}
+
+void saveRecording(PhysicsWorld& world) {
+  recording = false;
+  replay.finish(world);
+
+  // A replay that can't be saved shouldn't stop the game
+  try {
+    const std::filesystem::path REPLAY_DIR = std::filesystem::path(DATA_PATH).append("replays");
+    std::filesystem::create_directories(REPLAY_DIR);
+    replay.saveToFile(std::filesystem::path(REPLAY_DIR).append("lastRun.qr"));
+  } catch (const std::exception& e) {
+    std::cerr << "Couldn't save the replay: " << e.what() << std::endl;
+  }
+}
+
+bool tickWorld(PhysicsWorld& world) {
+  previousBallPosition = world.getBall().getMidpoint();
+
+  const bool RUNNING = world.tick();
+  for (const float STEP : world.getTickSteps()) {
+    replay.addStep(STEP);
+  }
+  return RUNNING;
+}
+
+void changeTimeScale() {
+  timeScaleIndex = (timeScaleIndex + 1) % NUM_TIME_SCALES;
+  const unsigned short TIME_SCALE = TIME_SCALES[timeScaleIndex];
+  timeScaleLabel.setText((TIME_SCALE == 0) ? "Skip" : std::to_string(TIME_SCALE) + "x");
+}
+
+void endRun(PhysicsWorld& world, Level& level) {
+  Globals::simulationOn = false;
+  world.reset();
+  level.getRunButton().setPosition(level.getRunButton().getPosition() + sf::Vector2f(0, 1e3));
+
+  // Check if the needed money bags have been collected
+  // If so, load the next level when the dialogue is finished
+  if (level.getScoreLabel().getScore() == level.getNeededScore()) {
+    levelCompleted = true;
+  } else {
+    level.resetMoneyBagPositions();
   }
 }
 
@@ -145,13 +283,13 @@ void mousePressedEvent(sf::Event& event, UIElements::Inventory& inventory, Level
   }
 
   for (UIElements::Button* pButton : allButtons) {
-    if (!pButton->intersect(sf::Mouse::getPosition(*Globals::window))) continue;
+    if (!pButton->intersect(Globals::platform->getMousePosition())) continue;
     pButton->onClick();
   }
   // Check click on EditableObjects
   UserObjects::EditableObject* clicked = nullptr;
   for (UserObjects::EditableObject* obj : editableObjects.getObjects()) {
-    if (obj->intersect(sf::Mouse::getPosition(*Globals::window)) && !Globals::simulationOn) {
+    if (obj->intersect(Globals::platform->getMousePosition()) && !Globals::simulationOn) {
       clicked = obj;
     }
   }
@@ -164,9 +302,9 @@ void mousePressedEvent(sf::Event& event, UIElements::Inventory& inventory, Level
 }
 
 void keyPressedEvent(UIElements::Inventory& inventory) {
-  if (sf::Keyboard::isKeyPressed(playerConf.getKeybind("ROTATE_CCW")) || sf::Keyboard::isKeyPressed(playerConf.getKeybind("ROTATE_CW"))) {
+  if (Globals::platform->isKeyPressed(playerConf.getKeybind("ROTATE_CCW")) || Globals::platform->isKeyPressed(playerConf.getKeybind("ROTATE_CW"))) {
     rotate = true;
-  } else if (sf::Keyboard::isKeyPressed(playerConf.getKeybind("MOVE")) && editing != nullptr) {
+  } else if (Globals::platform->isKeyPressed(playerConf.getKeybind("MOVE")) && editing != nullptr) {
     // Delete the object and enter building mode
     
     uint8_t itemId = editing->getItemId();
@@ -178,15 +316,12 @@ void keyPressedEvent(UIElements::Inventory& inventory) {
     
     editing = nullptr;
 
-    std::vector<UserObjects::EditableObject*>::iterator it;
-    if ((it = std::find(editableObjects.getObjects().begin(), editableObjects.getObjects().end(), tmpEditing)) != editableObjects.getObjects().end()) {
-      delete *it;
-      editableObjects.getObjects().erase(it);
-    }
+    // This also removes it from the physics world
+    editableObjects.removeObject(tmpEditing);
 
     inventory.changeCount(itemId, 1);
 
-  } else if (sf::Keyboard::isKeyPressed(playerConf.getKeybind("DELETE")) && editing != nullptr) {
+  } else if (Globals::platform->isKeyPressed(playerConf.getKeybind("DELETE")) && editing != nullptr) {
     // Delete the object and add one to the count in the inventory
     uint8_t itemId = editing->getItemId();
 
@@ -195,15 +330,24 @@ void keyPressedEvent(UIElements::Inventory& inventory) {
 
     editing = nullptr;
 
-    std::vector<UserObjects::EditableObject*>::iterator it;
-    if ((it = std::find(editableObjects.getObjects().begin(), editableObjects.getObjects().end(), tmpEditing)) != editableObjects.getObjects().end()) {
-      delete *it;
-      editableObjects.getObjects().erase(it);
-    }
+    editableObjects.removeObject(tmpEditing);
     
     inventory.changeCount(itemId, 1);
 
-  } else if (sf::Keyboard::isKeyPressed(playerConf.getKeybind("CANCEL"))) {
+  } else if (Globals::platform->isKeyPressed(playerConf.getKeybind("TIME_SCALE"))) {
+    changeTimeScale();
+
+  } else if (Globals::platform->isKeyPressed(playerConf.getKeybind("SAVE_TRACE"))) {
+    // Saves what the profiler has, for when a slowdown doesn't go over the frame budget
+    const std::filesystem::path TRACE_PATH = std::filesystem::path(DATA_PATH).append("traces/trace.json");
+    try {
+      Profiler::get().writeTrace(TRACE_PATH);
+      std::clog << "Saved the trace to " << TRACE_PATH.string() << std::endl;
+    } catch (const std::exception& e) {
+      std::cerr << e.what() << std::endl;
+    }
+
+  } else if (Globals::platform->isKeyPressed(playerConf.getKeybind("CANCEL"))) {
     // Cancel building or editing
     if (UserObjects::getBuilding()->getSize().length() != 0) UserObjects::clearBuilding();
 
@@ -212,14 +356,14 @@ void keyPressedEvent(UIElements::Inventory& inventory) {
 }
 
 void keyReleasedEvent() {
-  if (!sf::Keyboard::isKeyPressed(playerConf.getKeybind("ROTATE_CCW")) && !sf::Keyboard::isKeyPressed(playerConf.getKeybind("ROTATE_CW"))) {
+  if (!Globals::platform->isKeyPressed(playerConf.getKeybind("ROTATE_CCW")) && !Globals::platform->isKeyPressed(playerConf.getKeybind("ROTATE_CW"))) {
     rotate = false;
   }
 }
 
 // Loop
 
-void loop(sf::RenderWindow& window, PhysicsObjects::Ball& ball, Level& level, UIElements::Inventory& inventory, float deltaTime, Dialogue& dialogue, TextBubble& textBubble, UIElements::TextLabel& dialogueTextLabel) {
+void loop(Platform& platform, sf::Sprite& ballSprite, PhysicsWorld& world, Level& level, UIElements::Inventory& inventory, float deltaTime, Dialogue& dialogue, TextBubble& textBubble, UIElements::TextLabel& dialogueTextLabel) {
 
   if (!Globals::gameStarted) {
     mainMenu->loop_draw();
@@ -230,13 +374,8 @@ void loop(sf::RenderWindow& window, PhysicsObjects::Ball& ball, Level& level, UI
   // If so, increment the Globals::CurrentLevel
   if (levelCompleted && !Globals::dialoguePlaying) {
     ++Globals::currentLevel;
-    // Clear the editableObjects
-    for (UserObjects::EditableObject* object : editableObjects.getObjects()) {
-      delete object;
-    }
-    editableObjects.getObjects().clear();
-    // Clear the BouncyObjects
-    level.getBouncyObjects().getList().clear();
+    // Clear the editableObjects. The level's BouncyObjects get replaced when the next level is loaded
+    editableObjects.clear();
     levelCompleted = false;
   }
 
@@ -264,302 +403,415 @@ void loop(sf::RenderWindow& window, PhysicsObjects::Ball& ball, Level& level, UI
     }
   }
 
-  window.clear();
+  platform.clear();
 
-  sf::Event event;
-  while (window.pollEvent(event)) {
+  {
+    PROFILE_SCOPE("Events");
+    sf::Event event;
+    while (platform.pollEvent(event)) {
 
-    switch (event.type) {
+      switch (event.type) {
 
-      case sf::Event::Closed:
-        window.close();
-        break;
+        case sf::Event::Closed:
+          platform.close();
+          break;
       
-      case sf::Event::MouseButtonPressed:
-        mousePressedEvent(event, inventory, level);
-        break;
+        case sf::Event::MouseButtonPressed:
+          mousePressedEvent(event, inventory, level);
+          break;
       
-      case sf::Event::KeyPressed:
-        keyPressedEvent(inventory);
-        break;
+        case sf::Event::KeyPressed:
+          keyPressedEvent(inventory);
+          break;
       
-      case sf::Event::KeyReleased:
-        keyReleasedEvent();
-        break;
+        case sf::Event::KeyReleased:
+          keyReleasedEvent();
+          break;
       
-      default:
-        break;
-
-    }
+        default:
+          break;
 
-  }
+      }
 
-  // Just for debugging's sake. Stops the bal from abruptly teleporting down due to lag at the start.
-  if (deltaTime > 1) {
-    // Skip this frame
-    deltaTime = 0;
+    }
   }
 
   // Shows the credits if needed
   if (renderedLevel == 3) {
 
-    sf::RectangleShape background(static_cast<sf::Vector2f>(window.getSize()));
+    sf::RectangleShape background(static_cast<sf::Vector2f>(platform.getSize()));
     background.setFillColor(sf::Color(14, 19, 20));
-    window.draw(background);
+    platform.getTarget().draw(background);
 
     UIElements::TextLabel credits(
       "Credits:\n\n\n\n\nPatrick Vreeburg (Quasarium)\n\nExternal resources used:\nsvgrepo.com\nGoogle Fonts\nkbs.im (Keyboard sounds)\nsamplefocus.com (Bounce sample)",
-      sf::Vector2f(0.5f * window.getSize().x, 7.f * Globals::unitSize),
-      sf::Vector2f(static_cast<float>(window.getSize().x), 6.f * Globals::unitSize),
+      sf::Vector2f(0.5f * platform.getSize().x, 7.f * Globals::unitSize),
+      sf::Vector2f(static_cast<float>(platform.getSize().x), 6.f * Globals::unitSize),
       std::filesystem::path(RESOURCES_PATH).append("sprites/blank.png"),
-      sf::Color::White, Globals::mainFont, static_cast<int>(0.5f * Globals::unitSize)
+      sf::Color::White, Globals::getMainFont(), static_cast<int>(0.5f * Globals::unitSize)
     );
     credits.draw();
 
-    sf::Texture quasarLogoTexture;
-    if (!quasarLogoTexture.loadFromFile(std::filesystem::path(RESOURCES_PATH).append("sprites/quasarLogo.png"))) {
-      throw std::runtime_error("Couldn't load the Quasar logo sprite.");
-    }
-    sf::Sprite quasarLogo(quasarLogoTexture);
-    quasarLogo.setScale(sf::Vector2f(1.5f * unitSize / quasarLogoTexture.getSize().x, 1.5f * unitSize / quasarLogoTexture.getSize().y));
+    const SpriteRegion QUASAR_LOGO_SPRITE = Globals::getResources().getSprite(std::filesystem::path(RESOURCES_PATH).append("sprites/quasarLogo.png"));
+    sf::Sprite quasarLogo(*QUASAR_LOGO_SPRITE.texture, QUASAR_LOGO_SPRITE.rect);
+    quasarLogo.setScale(sf::Vector2f(1.5f * unitSize / QUASAR_LOGO_SPRITE.getSize().x, 1.5f * unitSize / QUASAR_LOGO_SPRITE.getSize().y));
     quasarLogo.setPosition(sf::Vector2f(4.5f * unitSize, 4.5f * unitSize));
 
-    window.draw(quasarLogo);
+    Globals::renderQueue.submit(RenderQueue::UI, QUASAR_LOGO_SPRITE, quasarLogo.getTransform());
 
     UIElements::TextLabel madeAs(
       "This was made as the intake assignment for",
-      sf::Vector2f(0.5f * window.getSize().x, 13.f * unitSize),
-      sf::Vector2f(static_cast<float>(window.getSize().x), 2.f * unitSize),
+      sf::Vector2f(0.5f * platform.getSize().x, 13.f * unitSize),
+      sf::Vector2f(static_cast<float>(platform.getSize().x), 2.f * unitSize),
       std::filesystem::path(RESOURCES_PATH).append("sprites/blank.png"),
-      sf::Color::White, Globals::mainFont, static_cast<int>(0.5f * unitSize)
+      sf::Color::White, Globals::getMainFont(), static_cast<int>(0.5f * unitSize)
     );
     madeAs.draw();
 
-    sf::Texture BUasLogoTexture;
-    if (!BUasLogoTexture.loadFromFile(std::filesystem::path(RESOURCES_PATH).append("sprites/BUasLogo.png"))) {
-      throw std::runtime_error("Couldn't load the Quasar logo sprite.");
-    }
-    sf::Sprite BUasLogo(BUasLogoTexture);
-    BUasLogo.setScale(sf::Vector2f(4.5f * unitSize / BUasLogoTexture.getSize().x, 1.5f * unitSize / BUasLogoTexture.getSize().y));
-    BUasLogo.setPosition(sf::Vector2f(0.5f * window.getSize().x - 2.25f * unitSize, 14.f * unitSize));
+    const SpriteRegion BUAS_LOGO_SPRITE = Globals::getResources().getSprite(std::filesystem::path(RESOURCES_PATH).append("sprites/BUasLogo.png"));
+    sf::Sprite BUasLogo(*BUAS_LOGO_SPRITE.texture, BUAS_LOGO_SPRITE.rect);
+    BUasLogo.setScale(sf::Vector2f(4.5f * unitSize / BUAS_LOGO_SPRITE.getSize().x, 1.5f * unitSize / BUAS_LOGO_SPRITE.getSize().y));
+    BUasLogo.setPosition(sf::Vector2f(0.5f * platform.getSize().x - 2.25f * unitSize, 14.f * unitSize));
 
-    window.draw(BUasLogo);
+    Globals::renderQueue.submit(RenderQueue::UI, BUAS_LOGO_SPRITE, BUasLogo.getTransform());
 
-    window.display();
+    Globals::renderQueue.flush(platform.getTarget());
+    platform.display();
     return;
   }
 
-  if (Globals::simulationOn) applyForces(ball, deltaTime);
-
-
-  for (PhysicsObjects::BouncyObject& object : level.getBouncyObjects().getList()) {
-    checkCollision(object, ball);
-    // Stop the simulation right before the ball falls through the ground
-    // or when the ball has glitched through a wall of the floor and is outside of the level
-    if (
-      (ball.getVelocity() < 25.f && object.getJustBounced() != -1 && Globals::simulationOn)
-      || (ball.getMidpoint().x < 0 || ball.getMidpoint().x > window.getSize().x || ball.getMidpoint().y < 0 || ball.getMidpoint().y > window.getSize().y)
-    ) {
-      Globals::simulationOn = false;
-      ball.setPosition(ballOrigin - 0.5f * ball.getGlobalBounds().getSize());
-      ball.setMidpoint(ballOrigin);
-      ball.setVelocity(sf::Vector2f());
-      level.getRunButton().setPosition(level.getRunButton().getPosition() + sf::Vector2f(0, 1e3));
-
-      // Check if the needed money bags have been collected
-      // If so, load the next level when the dialogue is finished
-      if (level.getScoreLabel().getScore() == level.getNeededScore()) {
-        levelCompleted = true;
-      } else {
-        level.resetMoneyBagPositions();
+  // The physics world handles the movement, the collisions and the money bags
+  // The frame time goes into the accumulator and the world moves forward in whole ticks. A faster time scale takes more ticks per frame.
+  // Every step gets recorded with its exact deltaTime, so the replay gives the same run
+  if (Globals::simulationOn) {
+    PROFILE_SCOPE("Physics");
+    if (!recording) {
+      startRecording(world, level);
+      physicsAccumulator = 0.f;
+      previousBallPosition = world.getBall().getMidpoint();
+    }
+
+    const unsigned short TIME_SCALE = TIME_SCALES[timeScaleIndex];
+    bool running = true;
+    if (TIME_SCALE == 0) {
+      // Only the end of a skipped run is drawn
+      for (unsigned ticks = 0; running && ticks < static_cast<unsigned>(MAX_SKIP_TIME / PhysicsWorld::TICK); ++ticks) {
+        running = tickWorld(world);
+      }
+      physicsAccumulator = 0.f;
+      renderAlpha = 1.f;
+    } else {
+      physicsAccumulator += TIME_SCALE * deltaTime;
+      unsigned ticks = 0;
+      while (running && physicsAccumulator >= PhysicsWorld::TICK && ticks < MAX_CATCH_UP_TICKS * TIME_SCALE) {
+        running = tickWorld(world);
+        physicsAccumulator -= PhysicsWorld::TICK;
+        ++ticks;
+      }
+      if (physicsAccumulator >= PhysicsWorld::TICK) {
+        physicsAccumulator = std::fmod(physicsAccumulator, PhysicsWorld::TICK);
       }
+      renderAlpha = physicsAccumulator / PhysicsWorld::TICK;
+    }
+
+    // The sounds of a skipped run would all play at the same time
+    handleWorldEvents(world, level, platform.getSize().y, TIME_SCALE != 0);
+    if (!running) {
+      // Before endRun, because it resets the world
+      saveRecording(world);
+      endRun(world, level);
     }
   }
 
   if (Globals::currentLevel >= 0){
-    window.draw(backgroundSprite);
-
-    level.getTilemap().drawPropsWalls(wallsTexture, propsTexture, sf::Vector2i(128, 128));
+    PROFILE_SCOPE("Scene");
+    // The level itself only gets drawn again when something changed it. The rest of the time it's copied from the layers
+    Globals::layers.draw(platform.getTarget(), SceneLayers::BACKGROUND, [&level](sf::RenderTarget& target) {
+      target.draw(backgroundSprite);
+      level.getTilemap().drawPropsWalls(target, *wallsTexture, *propsTexture, sf::Vector2i(128, 128));
+    });
   
-    window.draw(ball);
+    // The time since the last tick gets drawn too, so the ball moves smoothly on a screen that refreshes faster than the physics
+    PhysicsObjects::Ball& ball = world.getBall();
+    const sf::Vector2f BALL_POSITION = Globals::simulationOn ? previousBallPosition + renderAlpha * (ball.getMidpoint() - previousBallPosition) : ball.getMidpoint();
+    ballSprite.setPosition(BALL_POSITION - sf::Vector2f(ball.getRadius(), ball.getRadius()));
+    platform.getTarget().draw(ballSprite);
   
-    level.getTilemap().drawPipes(pipesTexture, sf::Vector2i(128, 128));
+    // The pipes, the user's objects and the money bags that are still there
+    Globals::layers.draw(platform.getTarget(), SceneLayers::FOREGROUND, [&level](sf::RenderTarget& target) {
+      level.getTilemap().drawPipes(target, *pipesTexture, sf::Vector2i(128, 128));
+      for (UserObjects::EditableObject* obj : editableObjects.getObjects()) {
+        obj->draw(Globals::renderQueue);
+      }
+      for (MoneyBag* bag : level.getMoneyBags()) {
+        if (!bag->getCollected()) bag->draw(Globals::renderQueue);
+      }
+      // Nothing else is in the queue yet, so this only draws the objects and the bags
+      Globals::renderQueue.flush(target);
+    });
   }
 
   if (renderedLevel == -1) {
     // Draw a background
-    sf::RectangleShape background(static_cast<sf::Vector2f>(window.getSize()));
+    sf::RectangleShape background(static_cast<sf::Vector2f>(platform.getSize()));
     background.setFillColor(sf::Color(14, 19, 20));
-    window.draw(background);
-  }
-
-  // Display the user's objects
-  for (UserObjects::EditableObject* obj : editableObjects.getObjects()) {
-    obj->draw();
-    if (obj->hasBouncyObject()) {
-      checkCollision(obj->getBouncyObject(), ball);
-      if (
-        (ball.getVelocity() < 25.f && obj->getBouncyObject().getJustBounced() != -1 && Globals::simulationOn)
-        || (ball.getMidpoint().x < 0 || ball.getMidpoint().x > window.getSize().x || ball.getMidpoint().y < 0 || ball.getMidpoint().y > window.getSize().y)
-      ) {
-        Globals::simulationOn = false;
-        ball.setPosition(ballOrigin - 0.5f * ball.getGlobalBounds().getSize());
-        ball.setMidpoint(ballOrigin);
-        ball.setVelocity(sf::Vector2f());
-        level.getRunButton().setPosition(level.getRunButton().getPosition() + sf::Vector2f(0, 1e3));
-
-        // Check if the needed money bags have been collected
-        // If so, load the next level when the dialogue is finished
-        if (level.getScoreLabel().getScore() == level.getNeededScore()) {
-          levelCompleted = true;
-        } else {
-          level.resetMoneyBagPositions();
-        }
-      }
-    }
-    if (obj->hasBooster()) {
-      int collSide = obj->getBooster().checkBallCollision(ball);
-      if (!obj->getBooster().getJustBoosted() && collSide != NULL_VALUE) {
-        obj->getBooster().boost(ball);
-      } else if (obj->getBooster().getJustBoosted() && collSide == NULL_VALUE) {
-        obj->getBooster().setJustBoosted(false);
-      }
-    }
+    platform.getTarget().draw(background);
   }
 
   if (Globals::currentLevel >= 0) {
-    // Display the money bags and check if the ball hits the bag.
-    // If the ball hits the bag, increase the score and make it fall.
+    // The collected money bags are falling. The world tells when the ball hits one (see handleWorldEvents)
     for (MoneyBag* bag : level.getMoneyBags()) {
-      bag->draw();
-      if (!bag->intersect(ball) || bag->getCollected()) {
-        continue;
-      }
-      bag->setCollected(true);
-      level.getScoreLabel().setScore(level.getScoreLabel().getScore() + bag->getValue());
-      
-      Globals::threads.emplace_back(std::bind(&MoneyBag::fall, bag, ball, window.getSize().y));
-      Globals::threads.back().detach();
+      if (bag->getCollected()) bag->draw(Globals::renderQueue);
     }
-
-    // Draw the UI
-    inventory.draw();
-    level.getScoreLabel().draw();
-    if (!levelCompleted)
-      level.getRunButton().draw();
   }
 
-  dialogueTextLabel.draw();
-  textBubble.draw();
+  {
+    PROFILE_SCOPE("UI");
+    if (Globals::currentLevel >= 0) {
+      // Draw the UI
+      inventory.draw();
+      level.getScoreLabel().draw();
+      if (!levelCompleted)
+        level.getRunButton().draw();
+      if (Globals::simulationOn)
+        timeScaleLabel.draw();
+    }
 
-  if (editing != nullptr) {
-    editGUI.drawBackground();
-    editGUI.draw();
-  }
-  if (UserObjects::getBuilding()->getSize().length() != 0) {
-    buildGUI.drawBackground();
-    buildGUI.draw();
+    dialogueTextLabel.draw(RenderQueue::POPUP);
+    textBubble.draw();
+
+    if (editing != nullptr) {
+      editGUI.drawBackground();
+      editGUI.draw(RenderQueue::POPUP);
+    }
+    if (UserObjects::getBuilding()->getSize().length() != 0) {
+      buildGUI.drawBackground();
+      buildGUI.draw(RenderQueue::POPUP);
+    }
   }
 
   // Determine if the player is building something. If so, call the ghost object's loop()
   if (UserObjects::getBuilding()->getSize().length() != 0) {
-    UserObjects::getBuilding()->loop(rotate, playerConf);
+    UserObjects::getBuilding()->loop(rotate, playerConf, world);
   }
-  
-  window.display();
+
+  // Everything but the level and the ball went into the queue. The flush has its own scope (RenderQueue::flush)
+  Globals::renderQueue.flush(platform.getTarget());
+
+  // Waits for vsync, so it's kept apart from the drawing
+  PROFILE_SCOPE("Display");
+  platform.display();
 
 }
 
-void loadTexture(std::string pathFromRes, sf::Texture& value) {
+TextureHandle getTexture(std::string pathFromRes) {
 
   std::filesystem::path imgPath = RESOURCES_PATH;
   imgPath.append(pathFromRes);
 
-  if (!value.loadFromFile(imgPath)) {
-    throw std::runtime_error("Failed to load sprite!");
-  }
-  value.setSmooth(true);
+  return Globals::getResources().getTexture(imgPath, true);
 
 }
 
-int main() {
+SpriteRegion getSprite(std::string pathFromRes) {
 
-  // The window is square with a side of 80% of the shortest edge of the screen
-  sf::Vector2u monitorSize = sf::VideoMode::getDesktopMode().size;
-  unsigned shortestEdge = (monitorSize.x > monitorSize.y) ? monitorSize.y : monitorSize.x;
+  std::filesystem::path imgPath = RESOURCES_PATH;
+  imgPath.append(pathFromRes);
 
-  sf::RenderWindow window(sf::VideoMode(
-    {static_cast<unsigned>(WINDOW_SIZE_FACTOR * shortestEdge), static_cast<unsigned>(WINDOW_SIZE_FACTOR * shortestEdge)}),
-    "BUas Intake Game"
-  );
+  return Globals::getResources().getSprite(imgPath, true);
+
+}
+
+void preloadAssets(Platform& platform) {
+  sf::Clock loadClock;
+
+  // Declared before the pool, so the pool (and the tasks that use the preloader) are gone first
+  AssetPreloader preloader(Globals::getResources());
+  for (const std::pair<const char*, bool>& texture : PRELOAD_TEXTURES) {
+    preloader.addTexture(std::filesystem::path(RESOURCES_PATH).append(texture.first), texture.second);
+  }
+  for (const char* sound : PRELOAD_SOUNDS) {
+    preloader.addSoundBuffer(std::filesystem::path(RESOURCES_PATH).append(sound));
+  }
+
+  WorkStealingPool pool;
+  preloader.start(pool);
+
+  // A headless run has nobody to show the progress to, and its script only counts the frames of the game itself.
+  // So it sleeps until the workers are done, and the loop below uploads everything at once
+  if (platform.isHeadless()) {
+    pool.wait();
+  }
+
+  // The textures are uploaded here, because this thread owns the OpenGL context. In the meantime, show how far it is
+  while (!preloader.upload()) {
+    sf::Event event;
+    while (platform.pollEvent(event)) {
+      if (event.type == sf::Event::Closed) {
+        platform.close();
+      }
+    }
+
+    // Closed while loading: don't decode the rest, and don't draw to the closed window. The running tasks use the preloader, so wait for them
+    if (!platform.isOpen()) {
+      pool.cancel();
+      pool.wait();
+      return;
+    }
 
-  // NOTE: Just temporary
-  window.setMaximumSize(window.getSize());
-  window.setMinimumSize(window.getSize());
+    platform.clear(sf::Color(14, 19, 20));
 
-  window.setFramerateLimit(0);
-  window.setVerticalSyncEnabled(true);
+    const float PROGRESS = static_cast<float>(preloader.getLoaded()) / static_cast<float>(preloader.getTotal());
+    sf::RectangleShape bar(sf::Vector2f(PROGRESS * 8.f * unitSize, 0.25f * unitSize));
+    bar.setPosition(0.5f * static_cast<sf::Vector2f>(platform.getSize()) - sf::Vector2f(4.f * unitSize, 0.125f * unitSize));
+    bar.setFillColor(sf::Color::White);
+    platform.getTarget().draw(bar);
+
+    platform.display();
+  }
+
+  std::cout << "Loaded " << preloader.getTotal() << " assets on " << pool.size() << " threads in " << loadClock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+
+  // For the time to the first frame
+  sf::Clock startupClock;
+
+  // With --headless <script.qi>, the game runs without a window and plays the input from the script (see NullPlatform)
+  // With --trace <path.json>, the whole game is saved as a Chrome trace when it closes.
+  // With --frame-budget <ms>, a frame that takes longer saves the seconds before it to DATA_PATH/traces (0 turns it off)
+  std::filesystem::path headlessScript;
+  std::filesystem::path tracePath;
+  float frameBudget = DEFAULT_FRAME_BUDGET;
+  for (int i = 1; i < argc; ++i) {
+    const std::string ARG = argv[i];
+    if (ARG == "--headless" && i + 1 < argc) {
+      headlessScript = argv[++i];
+    } else if (ARG == "--trace" && i + 1 < argc) {
+      tracePath = argv[++i];
+    } else if (ARG == "--frame-budget" && i + 1 < argc) {
+      try {
+        frameBudget = std::stof(argv[++i]);
+      } catch (const std::exception&) {
+        std::cerr << "Invalid frame budget: " << argv[i] << std::endl;
+        return 1;
+      }
+    } else {
+      std::cerr << "Unknown option or missing value: " << ARG << std::endl;
+      return 1;
+    }
+  }
+
+  // The scopes are cheap enough to always record. The buffers only get saved on a hitch, with --trace or with the SAVE_TRACE key
+  Profiler::get().setEnabled(true);
+  Profiler::get().setThreadName("Main");
+  Profiler::get().setHitchBudget(frameBudget, std::filesystem::path(DATA_PATH).append("traces"));
+
+  std::unique_ptr<Platform> platform;
+  NullPlatform* headless = nullptr;
+  if (headlessScript.empty()) {
+    // The window is square with a side of 80% of the shortest edge of the screen
+    sf::Vector2u monitorSize = sf::VideoMode::getDesktopMode().size;
+    unsigned shortestEdge = (monitorSize.x > monitorSize.y) ? monitorSize.y : monitorSize.x;
+
+    platform = std::make_unique<SfmlPlatform>(
+      sf::Vector2u(static_cast<unsigned>(WINDOW_SIZE_FACTOR * shortestEdge), static_cast<unsigned>(WINDOW_SIZE_FACTOR * shortestEdge)),
+      "BUas Intake Game"
+    );
+  } else {
+    // The size doesn't depend on the machine, so the clicks in the script always hit the same buttons
+    std::unique_ptr<NullPlatform> nullPlatform = std::make_unique<NullPlatform>(HEADLESS_WINDOW_SIZE);
+    headless = nullPlatform.get();
+    platform = std::move(nullPlatform);
+    // Nobody sees the layers, so drawing them straight onto the target saves the render textures
+    Globals::layers.setEnabled(false);
+  }
 
   // Set the unit size (conversion from pixels to 'meters') to 1/18 (16x16 for the level, 1 on eacht side for the wall tiles) of the screen width
-  unitSize = static_cast<float>(window.getSize().y) / 17.f;
+  unitSize = static_cast<float>(platform->getSize().y) / 17.f;
   unitSize = std::round(unitSize);
   std::cout << "Unit size is: " << unitSize <<std::endl;
-  windowSize = window.getSize();
+  windowSize = platform->getSize();
 
   // Set the window-related global variables and initialise the global font
   Globals::unitSize = unitSize;
-  Globals::window = &window;
+  Globals::platform = platform.get();
   Globals::initFont();
 
+  // Most sprites are packed into an atlas by the build (see tools/atlas.cpp). Without it, every sprite is loaded from its own file
+  const std::filesystem::path ATLAS_INDEX = std::filesystem::path(RESOURCES_PATH).append("atlas/sprites.qa");
+  if (std::filesystem::exists(ATLAS_INDEX)) {
+    Globals::getResources().loadAtlas(ATLAS_INDEX);
+  }
+
+  // Decode the images and sounds in parallel, instead of one by one on this thread
+  preloadAssets(*platform);
+  if (!platform->isOpen()) {
+    return 0;
+  }
+
   // Set the ball origin
   ballOrigin = {2.f * unitSize, 0.0f * unitSize};
 
+  // The time scale is shown in the top-right corner during a run
+  timeScaleLabel = UIElements::TextLabel(
+    "1x",
+    sf::Vector2f(platform->getSize().x - 1.5f * unitSize, 0.325f * unitSize),
+    sf::Vector2f(2.f * unitSize, 0.65f * unitSize),
+    std::filesystem::path(RESOURCES_PATH).append("sprites/scoreLabelBackground.png"),
+    sf::Color::Black
+  );
+
   // Init the editGUI
   editGUI = UIElements::EditGUI(sf::Vector2f(2.f * Globals::unitSize, 14.f * Globals::unitSize), sf::Vector2f(4.f * Globals::unitSize, 4.f * Globals::unitSize));
   buildGUI = UIElements::BuildGUI(sf::Vector2f(2.f * Globals::unitSize, 14.f * Globals::unitSize), sf::Vector2f(4.f * Globals::unitSize, 4.f * Globals::unitSize));
 
-  sf::Texture ballTexture;
-  loadTexture("sprites/ball.png", ballTexture);
+  const SpriteRegion BALL_REGION = getSprite("sprites/ball.png");
 
-  ballTexture.setSmooth(true);
+  // The physics world owns the ball. The game only draws a sprite where the ball is
+  PhysicsWorld world{unitSize, static_cast<sf::Vector2f>(windowSize), ballOrigin, 0.1f, 0.25f * unitSize};
+  editableObjects.setWorld(&world);
 
-  PhysicsObjects::Ball ball{ballTexture, ballOrigin, 0.1f, 0.25f * unitSize};
+  sf::Sprite ballSprite(*BALL_REGION.texture, BALL_REGION.rect);
+  const float BALL_FACTOR = (2 * world.getBall().getRadius()) / BALL_REGION.getSize().x;
+  ballSprite.setScale({BALL_FACTOR, BALL_FACTOR});
 
   // Initialise the button outer texture and the items
-  sf::Texture itemOuter;
-  loadTexture("sprites/itemBackground.png", itemOuter);
+  const SpriteRegion ITEM_OUTER = getSprite("sprites/itemBackground.png");
 
   // Create the inventory
-  UIElements::Inventory inventory{{0}, {0}, itemOuter};
+  UIElements::Inventory inventory{{0}, {0}, ITEM_OUTER};
 
   // Load all of the texture atlases
-  loadTexture("sprites/tilemapWall.png", wallsTexture);
-  loadTexture("sprites/tilemapProps.png", propsTexture);
-  loadTexture("sprites/tilemapPipes.png", pipesTexture);
+  wallsTexture = getTexture("sprites/tilemapWall.png");
+  propsTexture = getTexture("sprites/tilemapProps.png");
+  pipesTexture = getTexture("sprites/tilemapPipes.png");
 
-  loadTexture("sprites/background.png", backgroundTexture);
+  backgroundRegion = getSprite("sprites/background.png");
 
   // Configure the background sprite
-  backgroundSprite.setTexture(backgroundTexture, true);
+  backgroundSprite.setTexture(*backgroundRegion.texture);
+  backgroundSprite.setTextureRect(backgroundRegion.rect);
 
-  backgroundSprite.setOrigin(0.5f * static_cast<sf::Vector2f>(backgroundTexture.getSize()));
-  backgroundSprite.setPosition(0.5f * static_cast<sf::Vector2f>(window.getSize()));
-  backgroundSprite.setScale(sf::Vector2f(window.getSize().x / static_cast<float>(backgroundTexture.getSize().x), window.getSize().y / static_cast<float>(backgroundTexture.getSize().y)));
+  backgroundSprite.setOrigin(0.5f * backgroundRegion.getSize());
+  backgroundSprite.setPosition(0.5f * static_cast<sf::Vector2f>(platform->getSize()));
+  backgroundSprite.setScale(sf::Vector2f(platform->getSize().x / backgroundRegion.getSize().x, platform->getSize().y / backgroundRegion.getSize().y));
 
   // Initialise the first level, just temporary
   std::filesystem::path tmppath = RESOURCES_PATH;
   tmppath += "levels/level0.ql";
 
-  Level level{tmppath, wallsTexture, propsTexture, pipesTexture, inventory};
+  Level level{tmppath, *wallsTexture, *propsTexture, *pipesTexture, inventory, world};
 
   // Initiate the dialogue text elements
   TextBubble textBubble(std::string(48, ' '));
   UIElements::TextLabel dialogueTextLabel = UIElements::TextLabel(
     "",
-    sf::Vector2f(0.5f * Globals::window->getSize().x, 0.5f * Globals::window->getSize().x - Globals::unitSize),
+    sf::Vector2f(0.5f * Globals::platform->getSize().x, 0.5f * Globals::platform->getSize().x - Globals::unitSize),
     sf::Vector2f(10.f * Globals::unitSize, 4.f * Globals::unitSize),
     std::filesystem::path(RESOURCES_PATH).append("sprites/blank.png"),
-    sf::Color::White, Globals::mainFont, static_cast<int>(0.6f * Globals::unitSize)
+    sf::Color::White, Globals::getMainFont(), static_cast<int>(0.6f * Globals::unitSize)
   );
   Dialogue dialogue;
   dialogue.loadFromFile(std::filesystem::path(RESOURCES_PATH).append("dialogues/intro.qd"));
@@ -567,33 +819,88 @@ int main() {
   // Load the config
   playerConf.loadFromFile(std::filesystem::path(DATA_PATH).append("playerConfig.qconf"));
 
+  // The script presses keys by their keybind names, so it needs the config
+  if (headless != nullptr) {
+    try {
+      headless->loadScript(headlessScript, playerConf);
+    } catch (const std::exception& e) {
+      std::cerr << e.what() << std::endl;
+      delete mainMenu;
+      return 1;
+    }
+  }
+
   // Initialise the main menu
   mainMenu = new MainMenu(&level, &playerConf);
 
   // Initialise the ball bounce sounds
-  if (!bouncePadBuffer.loadFromFile(std::filesystem::path(RESOURCES_PATH).append("audio/bounce_pad.wav"))) {
-    throw std::runtime_error("Couldn't load the bounce pad bounce sound.");
-  }
-  if (!bounceWallBuffer.loadFromFile(std::filesystem::path(RESOURCES_PATH).append("audio/bounce_wall.wav"))) {
-    throw std::runtime_error("Couldn't load the wall bounce sound.");
+  bouncePadBuffer = Globals::getResources().getSoundBuffer(std::filesystem::path(RESOURCES_PATH).append("audio/bounce_pad.wav"));
+  bounceWallBuffer = Globals::getResources().getSoundBuffer(std::filesystem::path(RESOURCES_PATH).append("audio/bounce_wall.wav"));
+  boostBuffer = Globals::getResources().getSoundBuffer(std::filesystem::path(RESOURCES_PATH).append("audio/boost.wav"));
+  boostSlowerBuffer = Globals::getResources().getSoundBuffer(std::filesystem::path(RESOURCES_PATH).append("audio/slower.wav"));
+
+  // A headless run drops its sounds, so it doesn't need the audio thread
+  if (headless == nullptr) {
+    Globals::audio.start();
   }
 
   // Delta time clock
   sf::Clock dt_clock;
 
-  while (window.isOpen()) {
+  // The frame times of a headless run
+  sf::Clock frameClock;
+  float totalFrameTime = 0.f;
+  float maxFrameTime = 0.f;
+
+  bool firstFrame = true;
+  while (platform->isOpen()) {
     float deltaTime = dt_clock.restart().asSeconds();
-    loop(window, ball, level, inventory, deltaTime, dialogue, textBubble, dialogueTextLabel);
+    // A headless run always takes the same steps, so two runs of the same script can be compared
+    if (headless != nullptr) deltaTime = HEADLESS_DELTA_TIME;
+
+    frameClock.restart();
+    {
+      PROFILE_SCOPE("Frame");
+      loop(*platform, ballSprite, world, level, inventory, deltaTime, dialogue, textBubble, dialogueTextLabel);
+    }
+    Profiler::get().endFrame();
+    const float FRAME_TIME = frameClock.getElapsedTime().asSeconds() * 1000.f;
+    totalFrameTime += FRAME_TIME;
+    maxFrameTime = std::max(maxFrameTime, FRAME_TIME);
+
+    if (firstFrame) {
+      std::cout << "Time to first frame: " << startupClock.getElapsedTime().asMilliseconds() << " ms" << std::endl;
+      firstFrame = false;
+    }
+  }
+
+  if (headless != nullptr && headless->getFrame() > 0) {
+    const float FRAMES = static_cast<float>(headless->getFrame());
+    std::cout << "Headless run: " << headless->getFrame() << " frames, "
+      << totalFrameTime / FRAMES << " ms per frame on average, " << maxFrameTime << " ms at most, "
+      << static_cast<float>(headless->getDrawCalls()) / FRAMES << " draw calls per frame, "
+      << headless->getSoundsDropped() << " sounds" << std::endl;
+  }
+
+  if (!tracePath.empty()) {
+    try {
+      Profiler::get().writeTrace(tracePath);
+      std::cout << "Saved the trace to " << tracePath.string() << std::endl;
+    } catch (const std::exception& e) {
+      std::cerr << e.what() << std::endl;
+    }
   }
 
   // Clean main menu pointer
   delete mainMenu;
 
+  Globals::audio.stop();
+
   return 0;
 }
 
 // Windows :(
 // Why do you force me to use this function
 int WinMain() {
-  return main();
+  return main(0, nullptr);
 }
\ No newline at end of file
@@ -23,11 +23,11 @@
 #include <cmath>
 #include <cstddef>
 #include <filesystem>
-#include <stdexcept>
 #include <string>
 
 #include "../include/config.hpp"
 #include "../include/globals.hpp"
+#include "../include/render.hpp"
 #include "../include/level.hpp"
 #include "../include/ui.hpp"
 
@@ -39,32 +39,25 @@ UIElements::Button* keybindEditing = nullptr;
 
 MainMenu::MainMenu(Level* _level, Config* _config) : level(_level), config(_config) {
   
-  sf::Texture playSettings;
-  if (!playSettings.loadFromFile(std::filesystem::path(RESOURCES_PATH).append("sprites/genericButtonBackground.png"))) {
-    throw std::runtime_error("Couldn't load the texture for the play and settings buttons.");
-  }
-
-  sf::Texture blank;
-  if (!blank.loadFromFile(std::filesystem::path(RESOURCES_PATH).append("sprites/blank.png"))) {
-    throw std::runtime_error("Couldn't load the blank texture.");
-  }
+  const SpriteRegion PLAY_SETTINGS = Globals::getResources().getSprite(std::filesystem::path(RESOURCES_PATH).append("sprites/genericButtonBackground.png"));
+  const SpriteRegion BLANK = Globals::getResources().getSprite(std::filesystem::path(RESOURCES_PATH).append("sprites/blank.png"));
 
   this->play = UIElements::Button(
-    playSettings, sf::Vector2f(0.5f * Globals::window->getSize().x, 0.5f * Globals::window->getSize().y + 2.5f * Globals::unitSize),
+    PLAY_SETTINGS, sf::Vector2f(0.5f * Globals::platform->getSize().x, 0.5f * Globals::platform->getSize().y + 2.5f * Globals::unitSize),
     sf::Vector2u(static_cast<unsigned>(8.f * Globals::unitSize), static_cast<unsigned>(2.f * Globals::unitSize)), "   Play   ", sf::Color::White
   );
 
   this->settings = UIElements::Button(
-    playSettings, sf::Vector2f(0.5f * Globals::window->getSize().x, 0.5f * Globals::window->getSize().y + 5.5f * Globals::unitSize),
+    PLAY_SETTINGS, sf::Vector2f(0.5f * Globals::platform->getSize().x, 0.5f * Globals::platform->getSize().y + 5.5f * Globals::unitSize),
     sf::Vector2u(static_cast<unsigned>(8.f * Globals::unitSize), static_cast<unsigned>(2.f * Globals::unitSize)), "Settings", sf::Color::White
   );
 
   this->back = UIElements::Button(
-    blank, sf::Vector2f(2.f * Globals::unitSize, 15.7f * Globals::unitSize),
+    BLANK, sf::Vector2f(2.f * Globals::unitSize, 15.7f * Globals::unitSize),
     sf::Vector2u(static_cast<unsigned>(3.f * Globals::unitSize), static_cast<unsigned>(2.f * Globals::unitSize)), "Back", sf::Color::White
   );
 
-  const int NUM_KEYBINDS = 7;
+  const int NUM_KEYBINDS = 8;
   const std::pair<std::string, std::string> KEYBIND_NAMES[NUM_KEYBINDS] = {
     {"ROTATE_CCW", "Rotate counterclockwise"},
     {"ROTATE_CW", "Rotate clockwise"},
@@ -72,7 +65,8 @@ MainMenu::MainMenu(Level* _level, Config* _config) : level(_level), config(_conf
     {"ROTATE_BIG", "Rotate faster"},
     {"MOVE", "Move"},
     {"DELETE", "Delete"},
-    {"CANCEL", "Cancel"}
+    {"CANCEL", "Cancel"},
+    {"TIME_SCALE", "Run speed"}
   };
 
   this->keybindNames = {
@@ -82,14 +76,10 @@ MainMenu::MainMenu(Level* _level, Config* _config) : level(_level), config(_conf
     "ROTATE_BIG", 
     "MOVE",
     "DELETE",
-    "CANCEL"
+    "CANCEL",
+    "TIME_SCALE"
   };
 
-  sf::Texture buttonBackground;
-  if (!buttonBackground.loadFromFile(std::filesystem::path(RESOURCES_PATH).append("sprites/blank.png"))) {
-    throw std::runtime_error("Couldn't load the background for the keybind buttons");
-  }
-
   for (short i = 0; i < NUM_KEYBINDS; ++i) {
     auto& keybind = KEYBIND_NAMES[i];
     std::string keybindDesc = sf::Keyboard::getDescription(this->config->getKeybind(keybind.first)).toAnsiString();
@@ -109,7 +99,7 @@ MainMenu::MainMenu(Level* _level, Config* _config) : level(_level), config(_conf
         sf::Color::White
       ),
       UIElements::Button(
-        buttonBackground, sf::Vector2f(12.f * Globals::unitSize, 3.f * Globals::unitSize + 1.3f * i * Globals::unitSize),
+        BLANK, sf::Vector2f(12.f * Globals::unitSize, 3.f * Globals::unitSize + 1.3f * i * Globals::unitSize),
         sf::Vector2u(static_cast<unsigned>(4.f * Globals::unitSize), static_cast<unsigned>(Globals::unitSize)),
         keybindDesc,
         sf::Color::White
@@ -121,40 +111,37 @@ MainMenu::MainMenu(Level* _level, Config* _config) : level(_level), config(_conf
 
 void MainMenu::loop_draw() {
 
-  Globals::window->clear();
+  Globals::platform->clear();
 
   // Draw background
-  sf::RectangleShape background(static_cast<sf::Vector2f>(Globals::window->getSize()));
+  sf::RectangleShape background(static_cast<sf::Vector2f>(Globals::platform->getSize()));
   background.setFillColor(sf::Color(14, 19, 20));
 
-  Globals::window->draw(background);
+  Globals::platform->getTarget().draw(background);
 
   if (!this->settingsMenu) {
 
-    sf::Texture titleTexture;
-    if (!titleTexture.loadFromFile(std::filesystem::path(RESOURCES_PATH).append("sprites/title.png"))) {
-      throw std::runtime_error("Couldn't load the title texture.");
-    }
-    sf::Sprite title(titleTexture);
+    const SpriteRegion TITLE_SPRITE = Globals::getResources().getSprite(std::filesystem::path(RESOURCES_PATH).append("sprites/title.png"));
+    sf::Sprite title(*TITLE_SPRITE.texture, TITLE_SPRITE.rect);
   
-    title.setOrigin(0.5f * static_cast<sf::Vector2f>(titleTexture.getSize()));
-    title.setScale(sf::Vector2f(12.f * Globals::unitSize / titleTexture.getSize().x, 6.f * Globals::unitSize / titleTexture.getSize().y));
-    title.setPosition(sf::Vector2f(0.5f * Globals::window->getSize().x, 0.5f * Globals::window->getSize().y - 3.f * Globals::unitSize));
+    title.setOrigin(0.5f * TITLE_SPRITE.getSize());
+    title.setScale(sf::Vector2f(12.f * Globals::unitSize / TITLE_SPRITE.getSize().x, 6.f * Globals::unitSize / TITLE_SPRITE.getSize().y));
+    title.setPosition(sf::Vector2f(0.5f * Globals::platform->getSize().x, 0.5f * Globals::platform->getSize().y - 3.f * Globals::unitSize));
   
-    Globals::window->draw(title);
+    Globals::renderQueue.submit(RenderQueue::UI, TITLE_SPRITE, title.getTransform());
     this->play.draw();
     this->settings.draw();
 
   } else if (this->settingsMenu) {
 
     UIElements::TextLabel controlsHeader(
-      "Controls", sf::Vector2f(0.5f * Globals::window->getSize().x, 0.75f * Globals::unitSize),
+      "Controls", sf::Vector2f(0.5f * Globals::platform->getSize().x, 0.75f * Globals::unitSize),
       sf::Vector2f(6.f * Globals::unitSize, 2.f * Globals::unitSize), std::filesystem::path(RESOURCES_PATH).append("sprites/blank.png")
     );
     controlsHeader.draw();
 
     UIElements::TextLabel controlsIntruction(
-      "Click a control and press any key to edit", sf::Vector2f(0.5f * Globals::window->getSize().x, 1.75f * Globals::unitSize),
+      "Click a control and press any key to edit", sf::Vector2f(0.5f * Globals::platform->getSize().x, 1.75f * Globals::unitSize),
       sf::Vector2f(10.f * Globals::unitSize, 2.f * Globals::unitSize), std::filesystem::path(RESOURCES_PATH).append("sprites/blank.png"),
       sf::Color(155,155,155)
     );
@@ -170,10 +157,10 @@ void MainMenu::loop_draw() {
 
       sf::RectangleShape line(sf::Vector2f(11.f * Globals::unitSize, 0.075f * Globals::unitSize));
       line.setOrigin(sf::Vector2f(5.5f * Globals::unitSize, 0.0375f * Globals::unitSize));
-      line.setPosition(sf::Vector2f(0.5f * Globals::window->getSize().x, 3.7f * Globals::unitSize + 1.3f * i * Globals::unitSize));
+      line.setPosition(sf::Vector2f(0.5f * Globals::platform->getSize().x, 3.7f * Globals::unitSize + 1.3f * i * Globals::unitSize));
       line.setFillColor(sf::Color(155,155,155));
 
-      Globals::window->draw(line);
+      Globals::renderQueue.submit(RenderQueue::UI, line);
     }
 
     this->back.draw();
@@ -181,31 +168,31 @@ void MainMenu::loop_draw() {
   }
 
   sf::Event event;
-  while (Globals::window->pollEvent(event)) {
+  while (Globals::platform->pollEvent(event)) {
     switch (event.type) {
 
     case sf::Event::Closed:
-      Globals::window->close();
+      Globals::platform->close();
       break;
     
     case sf::Event::MouseButtonPressed:
       if (event.mouseButton.button != sf::Mouse::Button::Left) break;
       // Check button clicks (main screen)
-      if (this->play.intersect(sf::Mouse::getPosition(*Globals::window)) && !this->settingsMenu) {
+      if (this->play.intersect(Globals::platform->getMousePosition()) && !this->settingsMenu) {
         
         Globals::gameStarted = true;
         Globals::currentLevel = -1;
 
       }
-      if (this->settings.intersect(sf::Mouse::getPosition(*Globals::window)) && !this->settingsMenu)
+      if (this->settings.intersect(Globals::platform->getMousePosition()) && !this->settingsMenu)
         this->settingsMenu = true;
 
-      if (this->back.intersect(sf::Mouse::getPosition(*Globals::window)) && this->settingsMenu)
+      if (this->back.intersect(Globals::platform->getMousePosition()) && this->settingsMenu)
         this->settingsMenu = false;
       
       // Check button clicks (settings)
       for (size_t i = 0; i < this->controls.size(); ++i) {
-        if (!this->controls[i].second.intersect(sf::Mouse::getPosition(*Globals::window)) || !this->settingsMenu) {
+        if (!this->controls[i].second.intersect(Globals::platform->getMousePosition()) || !this->settingsMenu) {
           continue;
         }
         keybindEditing = &this->controls[i].second;
@@ -238,6 +225,7 @@ void MainMenu::loop_draw() {
     }
   }
 
-  Globals::window->display();
+  Globals::renderQueue.flush(Globals::platform->getTarget());
+  Globals::platform->display();
 
 }
\ No newline at end of file
@@ -11,37 +11,31 @@
 
 #include "../include/physics.hpp"
 
-#include <SFML/Audio/SoundBuffer.hpp>
-#include <SFML/Graphics/RectangleShape.hpp>
 #include <SFML/System/Vector2.hpp>
-#include <SFML/System/Angle.hpp>
 #include <algorithm>
 #include <cmath>
-#include <filesystem>
 #include <iostream>
-#include <stdexcept>
-#include <vector>
 
 #include "../include/math.hpp"
-#include "../include/globals.hpp"
-#include "../include/audio.hpp"
 
-/**
- * @brief A way to represent a side as a line of the format ax+by=c. Also includes the side index.
- * 
- */
-struct Side {
-  float a, b, c;
-  unsigned short i;
-};
-
-const unsigned short NUM_SIDES = 4;
 enum sides {TOP, RIGHT, BOTTOM, LEFT};
 
 void printv(sf::Vector2f vec) {
   std::cout << "(" << vec.x << "," << vec.y << ")" << std::endl;
 }
 
+PhysicsObjects::Points PhysicsObjects::getRectanglePoints(const sf::Vector2f& center, const sf::Vector2f& size, const float rotation) {
+  // This does the same as an sf::RectangleShape with its origin in the middle, but without needing the graphics module.
+  // The order is the same as the one that was used with the RectangleShape: point 1, 2, 3 and then 0.
+  const sf::Vector2f HALF = 0.5f * size;
+  return {
+    center + rotateVector(sf::Vector2f(HALF.x, -HALF.y), rotation),
+    center + rotateVector(sf::Vector2f(HALF.x, HALF.y), rotation),
+    center + rotateVector(sf::Vector2f(-HALF.x, HALF.y), rotation),
+    center + rotateVector(sf::Vector2f(-HALF.x, -HALF.y), rotation)
+  };
+}
+
 //////////////////////////////////////
 // Ball
 //////////////////////////////////////
@@ -59,224 +53,302 @@ void PhysicsObjects::Ball::applyForce(const float deltaTime, const float F, sf::
 
 }
 
-PhysicsObjects::Ball::Ball(const sf::Texture& texture, const sf::Vector2f mid, const float m, const float r) :
-      Sprite(texture), mass(m), midpoint(mid), radius(r)
-{
-  float factor = (2 * r) / static_cast<float>(texture.getSize().x);
-  this->setScale({factor, factor});
-  this->setPosition(mid - sf::Vector2f(r, r));
-}
-
-void PhysicsObjects::Ball::setRadius(const float newRadius) {
-  radius = newRadius;
-  float factor = (2 * newRadius) / static_cast<float>(this->getTexture().getSize().x);
-  this->setScale({factor, factor});
-  this->setOrigin({newRadius, newRadius});
-  this->setPosition(this->midpoint - sf::Vector2f(newRadius, newRadius));
-}
+PhysicsObjects::Ball::Ball(const sf::Vector2f mid, const float m, const float r) : mass(m), midpoint(mid), radius(r) {}
 
 void PhysicsObjects::Ball::updatePoistion(const float deltaTime) {
 
   // Because the SFML coordinate system has (0,0) top-left, the y has to be -='ed. I want to have my physics be normal, but "down is up" in SFML...
   this->midpoint.x += this->velocityVector.x * deltaTime;
   this->midpoint.y -= this->velocityVector.y * deltaTime;
-  this->setPosition(this->midpoint - sf::Vector2f(this->radius, this->radius));
 
 }
 
-sf::Vector2f PhysicsObjects::Ball::getDirection() {
-  if (velocityVector.length() == 0) {
+sf::Vector2f PhysicsObjects::getDirection(const sf::Vector2f& velocity) {
+  if (dotProduct(velocity, velocity) == 0) {
     return sf::Vector2f();
   }
-  return velocityVector.normalized();
+  return getNormalized(velocity);
+}
+
+sf::Vector2f PhysicsObjects::Ball::getDirection() {
+  return PhysicsObjects::getDirection(this->velocityVector);
 }
 
 //////////////////////////////////////
 // BouncyObject
 //////////////////////////////////////
 
-unsigned short getBestSide(PhysicsObjects::Ball& ball, std::vector<Side>& sides, std::vector<float>& distances) {
+void PhysicsObjects::BouncyObject::setPoints(const PhysicsObjects::Points& newPoints) {
+
+  this->points = newPoints;
+
+  // The points can be in clockwise or counterclockwise order, so use the center to make the normals point outwards
+  this->center = sf::Vector2f();
+  this->boundsMin = this->points[0];
+  this->boundsMax = this->points[0];
+  for (const sf::Vector2f& point : this->points) {
+    this->center += 0.25f * point;
+    this->boundsMin = sf::Vector2f(std::min(this->boundsMin.x, point.x), std::min(this->boundsMin.y, point.y));
+    this->boundsMax = sf::Vector2f(std::max(this->boundsMax.x, point.x), std::max(this->boundsMax.y, point.y));
+  }
+
+  for (unsigned short i = 0; i < NUM_SIDES; ++i) {
+    const sf::Vector2f POINT1 = this->points[i];
+    const sf::Vector2f POINT2 = this->points[(i+1)%NUM_SIDES];
+    Edge& edge = this->edges[i];
+
+    edge.start = POINT1;
+    edge.length = getLength(POINT2 - POINT1);
+    edge.direction = (edge.length == 0) ? sf::Vector2f() : (POINT2 - POINT1) / edge.length;
+
+    // The formula of the line. The a and b can be filled in by using the normal of the side.
+    const sf::Vector2f NORMAL = edge.direction.perpendicular();
+    edge.a = NORMAL.x;
+    edge.b = NORMAL.y;
+    edge.c = -1 * (edge.a * POINT1.x + edge.b * POINT1.y);
+
+    edge.outwardNormal = (dotProduct(POINT1 - this->center, NORMAL) < 0) ? -NORMAL : NORMAL;
+
+    edge.xDirection = std::abs(POINT2.x - POINT1.x) > std::abs(POINT2.y - POINT1.y);
+    edge.low = edge.xDirection ? std::min(POINT1.x, POINT2.x) : std::min(POINT1.y, POINT2.y);
+    edge.high = edge.xDirection ? std::max(POINT1.x, POINT2.x) : std::max(POINT1.y, POINT2.y);
+  }
+
+}
+
+unsigned short getBestSide(const sf::Vector2f& midpoint, const float radius, const sf::Vector2f& direction, const PhysicsObjects::Edge* const edges, const unsigned short* const sides, const unsigned short numSides, const float* const distances) {
   // Get the distance to both sides. Grab the smallest distance (x) and get the position of the ball x-1 pixels back.
   // Then, check wich side is closest.
-  float smallestDistance = *std::min_element(distances.begin(), distances.end());
-  sf::Vector2f ballBackPos = ball.getMidpoint() - (smallestDistance - 3) * ball.getDirection();
-  
-  std::vector<unsigned short> collSides;
-  for (Side side : sides) {
-    float distanceToMidpoint = getDistance(side.a, side.b, side.c, ballBackPos);
-    if (distanceToMidpoint < ball.getRadius()) {
-      collSides.push_back(side.i);
-    }
-  }
+  const float SMALLEST_DISTANCE = *std::min_element(distances, distances + PhysicsObjects::NUM_SIDES);
+  const sf::Vector2f BALL_BACK_POS = midpoint - (SMALLEST_DISTANCE - 3) * direction;
 
-  if (collSides.size() == 0) {
-    return sides[0].i;
+  for (unsigned short i = 0; i < numSides; ++i) {
+    const PhysicsObjects::Edge& EDGE = edges[sides[i]];
+    if (std::abs(getSignedDistance(EDGE.a, EDGE.b, EDGE.c, BALL_BACK_POS)) < radius) {
+      return sides[i];
+    }
   }
 
-  return collSides[0];
+  return sides[0];
 }
 
 int PhysicsObjects::BouncyObject::checkBallCollision(PhysicsObjects::Ball& ball) {
+  return this->checkCircleCollision(ball.getMidpoint(), ball.getRadius(), ball.getDirection());
+}
+
+int PhysicsObjects::BouncyObject::checkCircleCollision(const sf::Vector2f& midpoint, const float radius, const sf::Vector2f& direction) {
 
   // This collision system is very sketchy, but that's game dev for you. No need to be fully realistic ;).
-  // For each side, get the formula of the line and check if its distance to the midpoint of the ball is smaller than the radius of the ball.
+  // For each side, check if the distance from the line to the midpoint of the ball is smaller than the radius of the ball.
   // If so, project the midpoint of the ball on the line and check if it is inside the object.
   // If that is also the case, the ball collides.
+  // Everything about the sides is precomputed in setPoints(), so this doesn't allocate or take square roots.
 
-  std::vector<Side> collSides;
-  std::vector<Side> allSides;
-  std::vector<float> distances;
-
-  for (unsigned short i = 0; i < NUM_SIDES; ++i) {
-
-    // Get the formula
-    // The a and b can be filled in by using the normal of the side.
-
-    sf::Vector2f point1 = this->points[i];
-    sf::Vector2f point2 = this->points[(i+1)%4];
-
-    sf::Vector2f direction_vector = (point2 - point1).normalized();
-    sf::Vector2f normal = direction_vector.perpendicular();
+  const sf::Vector2f MID = midpoint;
+  const float RADIUS = radius;
 
-    float a, b, c;
-
-    a = normal.x;
-    b = normal.y;
+  // The corner check below can hit when the ball is up to sqrt(2) radii from a corner, so use a margin of 2 radii
+  if (
+    MID.x < this->boundsMin.x - 2.f * RADIUS || MID.x > this->boundsMax.x + 2.f * RADIUS ||
+    MID.y < this->boundsMin.y - 2.f * RADIUS || MID.y > this->boundsMax.y + 2.f * RADIUS
+  ) {
+    return -1;
+  }
 
-    c = -1 * (a * point1.x + b * point1.y);
+  unsigned short collSides[NUM_SIDES];
+  unsigned short numCollSides = 0;
+  float distances[NUM_SIDES];
 
-    allSides.push_back({a, b, c, i});
+  for (unsigned short i = 0; i < NUM_SIDES; ++i) {
 
-    float distanceToMidpoint = getDistance(a, b, c, ball.getMidpoint());
-    distances.push_back(distanceToMidpoint);
+    const Edge& EDGE = this->edges[i];
+    const float SIGNED_DISTANCE = getSignedDistance(EDGE.a, EDGE.b, EDGE.c, MID);
+    distances[i] = std::abs(SIGNED_DISTANCE);
 
-    if (distanceToMidpoint < ball.getRadius()) {
+    if (distances[i] < RADIUS) {
       // Hurray, at least the line is in the circle.
-      // Now to check if it is in the actual object, I multiply the normal with the distance and add it to the midpoint.
-      // If that point is on the line and not outside the side, it collides.
-
-      sf::Vector2f checkPoint = ball.getMidpoint() + distanceToMidpoint * normal;
-      if (std::round(a * checkPoint.x + b * checkPoint.y + c) == 0) {
-        // If xDirection is true, the side is more horizontal than vertical
-        bool xDirection = std::abs(point2.x - point1.x) > std::abs(point2.y - point1.y);
-        // Get the smallest and the biggest point based on the x or y coordinate (depending on xDirection).
-        sf::Vector2f smallest = 
-          (xDirection)
-          ? ((point1.x < point2.x) ? point1 : point2)
-          : ((point1.y < point2.y) ? point1 : point2);
-        sf::Vector2f biggest = (smallest == point1) ? point2 : point1;
-        // Check if the point is between the edges, thus in the object. If so, we collided with the side.
-        if (
-          (xDirection && checkPoint.x >= smallest.x && checkPoint.x <= biggest.x) ||
-          (!xDirection && checkPoint.y >= smallest.y && checkPoint.y <= biggest.y)
-        ) {
-          collSides.push_back({a,b,c, i});
-        }
-      }
-
-      checkPoint = ball.getMidpoint() + distanceToMidpoint * -normal;
-      // This is the same as the if-statement above.
-      if (std::round(a * checkPoint.x + b * checkPoint.y + c) == 0) {
-        // If xDirection is true, the side is more horizontal than vertical
-        bool xDirection = std::abs(point2.x - point1.x) > std::abs(point2.y - point1.y);
-        // Get the smallest and the biggest point based on the x or y coordinate (depending on xDirection).
-        sf::Vector2f smallest = 
-          (xDirection)
-          ? ((point1.x < point2.x) ? point1 : point2)
-          : ((point1.y < point2.y) ? point1 : point2);
-        sf::Vector2f biggest = (smallest == point1) ? point2 : point1;
-        // Check if the point is between the edges, thus in the object. If so, we collided with the side.
-        if (
-          (xDirection && checkPoint.x >= smallest.x && checkPoint.x <= biggest.x) ||
-          (!xDirection && checkPoint.y >= smallest.y && checkPoint.y <= biggest.y)
-        ) {
-          collSides.push_back({a,b,c, i});
-        }
+      // Now to check if it is in the actual object, project the midpoint on the line.
+      // If that point is not outside the side, it collides.
+      const sf::Vector2f CHECK_POINT = MID - SIGNED_DISTANCE * sf::Vector2f(EDGE.a, EDGE.b);
+      const float ALONG = EDGE.xDirection ? CHECK_POINT.x : CHECK_POINT.y;
+      if (ALONG >= EDGE.low && ALONG <= EDGE.high) {
+        collSides[numCollSides++] = i;
       }
     }
     
   }
 
   // Check if the ball is near a corner. If so, determine and return the side that it hit first.
-  for (unsigned short i = 1; i < distances.size(); ++i) {
+  for (unsigned short i = 1; i < NUM_SIDES; ++i) {
     // Check if both sides of a corner are even close enough to the ball.
-    if (!(distances[i] <= ball.getRadius() && distances[i-1] <= ball.getRadius())) {
+    if (!(distances[i] <= RADIUS && distances[i-1] <= RADIUS)) {
       continue;
     }
-    if (std::abs(distances[i] - distances[i-1]) <= 0.1f * Globals::unitSize) {
-      std::vector<Side> sides = std::vector<Side>({allSides[i-1], allSides[i]});
-      return getBestSide(ball, sides, distances);
+    // The margin used to be 0.1 unit, which is 0.4 times the radius of the ball (0.25 unit)
+    if (std::abs(distances[i] - distances[i-1]) <= 0.4f * RADIUS) {
+      const unsigned short CORNER_SIDES[2] = {static_cast<unsigned short>(i-1), i};
+      return getBestSide(MID, RADIUS, direction, this->edges.data(), CORNER_SIDES, 2, distances);
     }
   }
 
-  if (collSides.size() == 1) {
-    return collSides[0].i;
+  if (numCollSides == 1) {
+    return collSides[0];
   }
   // If more than one side collided, check which is the most plausible
   // So we look which side the ball is closest to
-  else if (collSides.size() > 1) {
-    return getBestSide(ball, collSides, distances);
+  else if (numCollSides > 1) {
+    return getBestSide(MID, RADIUS, direction, this->edges.data(), collSides, numCollSides, distances);
   }
 
   return -1;
 
 }
 
-void PhysicsObjects::BouncyObject::bounce(PhysicsObjects::Ball& ball, const short side) {
+int PhysicsObjects::BouncyObject::sweepBallCollision(PhysicsObjects::Ball& ball, const sf::Vector2f& displacement, float& timeOfImpact) {
+  return this->sweepCircleCollision(ball.getMidpoint(), ball.getRadius(), displacement, timeOfImpact);
+}
+
+int PhysicsObjects::BouncyObject::sweepCircleCollision(const sf::Vector2f& start, const float radius, const sf::Vector2f& displacement, float& timeOfImpact) {
+
+  // The ball is a circle moving in a straight line during the step, so it touches the shape either on a side or on a corner.
+  // For the sides: the midpoint has to come within one radius of the line, while its projection lies on the side.
+  // For the corners: the midpoint has to come within one radius of the point, which is a quadratic equation in t.
+  // The earliest t of all of these is the moment of impact.
+
+  const float RADIUS = radius;
+  const sf::Vector2f START = start;
+  const sf::Vector2f END = START + displacement;
+
+  // Skip the shape if the box around the whole movement of the ball doesn't touch the bounding box
+  if (
+    std::max(START.x, END.x) + RADIUS < this->boundsMin.x || std::min(START.x, END.x) - RADIUS > this->boundsMax.x ||
+    std::max(START.y, END.y) + RADIUS < this->boundsMin.y || std::min(START.y, END.y) - RADIUS > this->boundsMax.y
+  ) {
+    return -1;
+  }
+
+  float bestTime = 2.f;
+  int bestSide = -1;
+
+  // Sides
+  for (unsigned short i = 0; i < NUM_SIDES; ++i) {
+    const Edge& EDGE = this->edges[i];
+
+    const float START_DISTANCE = dotProduct(START - EDGE.start, EDGE.outwardNormal);
+    const float SPEED_TOWARDS = -dotProduct(displacement, EDGE.outwardNormal);
+    if (SPEED_TOWARDS <= 0 || START_DISTANCE <= -RADIUS) {
+      // Moving away from (or along) this side, or already past it
+      continue;
+    }
+
+    // If the ball already overlaps the line, it touches it right away
+    float t = (START_DISTANCE <= RADIUS) ? 0.f : (START_DISTANCE - RADIUS) / SPEED_TOWARDS;
+    if (t > 1.f || t >= bestTime) {
+      continue;
+    }
+
+    // Check if the midpoint is next to the side and not next to the extension of the line
+    const float ALONG = dotProduct(START + t * displacement - EDGE.start, EDGE.direction);
+    if (ALONG < 0.f || ALONG > EDGE.length) {
+      continue;
+    }
+
+    bestTime = t;
+    bestSide = i;
+  }
+
+  // Corners
+  const float A = dotProduct(displacement, displacement);
+  for (unsigned short i = 0; i < NUM_SIDES && A > 0; ++i) {
+    const float B = 2.f * dotProduct(START - this->points[i], displacement);
+    const float C = getDistanceSq(START, this->points[i]) - RADIUS * RADIUS;
+    if (B >= 0) {
+      // Moving away from the corner
+      continue;
+    }
 
-  // Take the inverse of the velocity vector of the ball and mirror it relative to this object's normal.
-  sf::Vector2f invVelocity = -(ball.getDirection() * ball.getVelocity());
-  sf::Vector2f newVelocity = cor * invVelocity.rotatedBy(2.f * invVelocity.angleTo(this->orientation.rotatedBy(sf::degrees(-90.f * (side-1)))));
+    float t;
+    if (C <= 0) {
+      t = 0.f;
+    } else {
+      const float DISCRIMINANT = B * B - 4.f * A * C;
+      if (DISCRIMINANT < 0) {
+        continue;
+      }
+      t = (-B - std::sqrt(DISCRIMINANT)) / (2.f * A);
+    }
+    if (t > 1.f || t >= bestTime) {
+      continue;
+    }
+
+    // The corner is shared by the previous side and this side. Pick the one that faces the ball the most
+    sf::Vector2f contactNormal = START + t * displacement - this->points[i];
+    unsigned short previous = (i + NUM_SIDES - 1) % NUM_SIDES;
+    bestTime = t;
+    bestSide = (dotProduct(contactNormal, this->edges[previous].outwardNormal) > dotProduct(contactNormal, this->edges[i].outwardNormal)) ? previous : i;
+  }
 
-  ball.setVelocity(newVelocity);
+  if (bestSide != -1) {
+    timeOfImpact = bestTime;
+  }
+  return bestSide;
+
+}
+
+void PhysicsObjects::BouncyObject::bounce(PhysicsObjects::Ball& ball, const short side) {
+
+  ball.setVelocity(this->getBouncedVelocity(ball.getVelocityVector(), side));
   this->setJustBounced(side);
 
 }
 
+sf::Vector2f PhysicsObjects::BouncyObject::getBouncedVelocity(const sf::Vector2f& velocity, const short side) {
+
+  // Mirror the velocity in the side that was hit. The normal of the side is the orientation rotated by -90 * (side-1) degrees,
+  // but the direction of the normal doesn't matter for the mirroring, so the odd sides use the orientation and the even sides its perpendicular.
+  // This is the same as rotating the inverse velocity by twice its angle to the normal, without the trigonometry.
+  const sf::Vector2f NORMAL = (side % 2 == 1) ? this->orientation : this->orientation.perpendicular();
+  return cor * reflect(velocity, NORMAL);
+
+}
+
+PhysicsObjects::BouncyObject PhysicsObjects::makeBouncePad(const sf::Vector2i& pos, const sf::Vector2f& size, const float rotation, const float unitSize, const float cor) {
+  PhysicsObjects::BouncyObject bouncePad;
+  bouncePad.setCOR(cor);
+  bouncePad.setOrientation(rotateVector(sf::Vector2f(1,0), 90.f - rotation));
+
+  // The points are the corners of the rotated rectangle. Same as in the Booster constructor
+  bouncePad.setPoints(PhysicsObjects::getRectanglePoints(static_cast<sf::Vector2f>(pos), size * unitSize, rotation));
+  return bouncePad;
+}
+
 //////////////////////////////////////
 // Booster => BouncyObject
 //////////////////////////////////////
 
-PhysicsObjects::Booster::Booster(const sf::Vector2i& newPos, const sf::Vector2f& newSize, const float newRotation, const float boostExtra)
+PhysicsObjects::Booster::Booster(const sf::Vector2i& newPos, const sf::Vector2f& newSize, const float newRotation, const float unitSize, const float boostExtra)
 : pos(newPos), size(newSize), rotation(newRotation), boostExtra(boostExtra), justBoosted(false) {
-  this->setOrientation(sf::Vector2f(1,0).rotatedBy(sf::degrees(90.f - newRotation)));
+  this->setOrientation(rotateVector(sf::Vector2f(1,0), 90.f - newRotation));
 
-  // For the points of the BouncyObject I use a RectangleShape and get its points
   // Also used in build.cpp
-  sf::RectangleShape rect(newSize * Globals::unitSize);
-  rect.setOrigin(0.5f * Globals::unitSize * newSize);
-  rect.setRotation(sf::degrees(newRotation));
-  rect.setPosition(static_cast<sf::Vector2f>(newPos));
-  sf::Transform transform = rect.getTransform();
-  this->setPoints({
-    transform.transformPoint(rect.getPoint(1)),
-    transform.transformPoint(rect.getPoint(2)),
-    transform.transformPoint(rect.getPoint(3)),
-    transform.transformPoint(rect.getPoint(0))
-  });
+  this->setPoints(PhysicsObjects::getRectanglePoints(static_cast<sf::Vector2f>(newPos), newSize * unitSize, newRotation));
 }
 
-void PhysicsObjects::Booster::boost(PhysicsObjects::Ball& ball) {
-  // This adds boosterExtra of the speed of the ball, rotated to face the arrow's direction
-  const sf::Vector2f ARROW_DIRECTION = this->getOrientation().normalized();
-
+bool PhysicsObjects::Booster::boost(PhysicsObjects::Ball& ball) {
   const float BEGIN_VELOCITY = ball.getVelocity();
 
-  ball.setVelocity((ball.getVelocity() * ball.getDirection()) + boostExtra * ball.getVelocity() * ARROW_DIRECTION);
+  ball.setVelocity(this->getBoostedVelocity(ball.getVelocityVector()));
 
   this->setJustBoosted(true);
 
-  // Play a sound depending on whether the ball accelerates or slows down
-  sf::SoundBuffer boostBuffer;
-  if (BEGIN_VELOCITY < ball.getVelocity()) {
-    if (!boostBuffer.loadFromFile(std::filesystem::path(RESOURCES_PATH).append("audio/boost.wav"))) {
-      throw std::runtime_error("Couldn't load the boost sound.");
-    }
-  } else {
-    if (!boostBuffer.loadFromFile(std::filesystem::path(RESOURCES_PATH).append("audio/slower.wav"))) {
-      throw std::runtime_error("Couldn't load the boost slower sound.");
-    }
-  }
-  Globals::threads.emplace_back(playSound, boostBuffer);
-  Globals::threads.back().detach();
-}
\ No newline at end of file
+  // The caller plays a sound depending on whether the ball accelerates or slows down
+  return BEGIN_VELOCITY < ball.getVelocity();
+}
+
+sf::Vector2f PhysicsObjects::Booster::getBoostedVelocity(const sf::Vector2f& velocity) {
+  // This adds boosterExtra of the speed of the ball, rotated to face the arrow's direction
+  const sf::Vector2f ARROW_DIRECTION = getNormalized(this->getOrientation());
+  const float SPEED = getLength(velocity);
+
+  return velocity + boostExtra * SPEED * ARROW_DIRECTION;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file platform.cpp
+ * @author Patrick Vreeburg
+ * @brief The window, input and sound of the game, or a stand-in for them without a window
+ * @version 0.1
+ * @date 2024-07-30
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "../include/platform.hpp"
+
+#include <SFML/Graphics/RenderWindow.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <SFML/Window/Event.hpp>
+#include <SFML/Window/Keyboard.hpp>
+#include <SFML/Window/Mouse.hpp>
+#include <SFML/Window/VideoMode.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/config.hpp"
+#include "../include/globals.hpp"
+#include "../include/resources.hpp"
+
+//////////////////////////////////////
+// SfmlPlatform
+//////////////////////////////////////
+
+SfmlPlatform::SfmlPlatform(const sf::Vector2u size, const std::string& title) : window(sf::VideoMode(size), title) {
+  // NOTE: Just temporary
+  this->window.setMaximumSize(this->window.getSize());
+  this->window.setMinimumSize(this->window.getSize());
+
+  this->window.setFramerateLimit(0);
+  this->window.setVerticalSyncEnabled(true);
+}
+
+sf::Vector2i SfmlPlatform::getMousePosition() const {
+  return sf::Mouse::getPosition(this->window);
+}
+
+bool SfmlPlatform::isKeyPressed(const sf::Keyboard::Scan key) const {
+  return sf::Keyboard::isKeyPressed(key);
+}
+
+bool SfmlPlatform::playSound(const SoundBufferHandle& buffer) {
+  return Globals::audio.play(buffer);
+}
+
+//////////////////////////////////////
+// NullPlatform
+//////////////////////////////////////
+
+void NullPlatform::loadScript(const std::filesystem::path& path, Config& config) {
+  std::ifstream file;
+  file.open(path, std::ios::in);
+
+  if (!file.is_open()) {
+    throw std::runtime_error("Couldn't open the input script " + path.string() + ".");
+  }
+
+  std::vector<ScriptedEvent> events;
+  std::string lineStr;
+  while (std::getline(file, lineStr)) {
+
+    if (lineStr.empty() || lineStr.front() == '%') continue;
+
+    std::istringstream line(lineStr);
+    size_t eventFrame;
+    std::string command;
+    if (!(line >> eventFrame >> command)) {
+      throw std::runtime_error("Invalid line in the input script: " + lineStr);
+    }
+
+    sf::Event event;
+    if (command == "MOVE" || command == "CLICK") {
+      int x, y;
+      if (!(line >> x >> y)) {
+        throw std::runtime_error("Invalid line in the input script: " + lineStr);
+      }
+      event.type = sf::Event::MouseMoved;
+      event.mouseMove = {x, y};
+      events.push_back({eventFrame, event});
+
+      if (command == "CLICK") {
+        event.type = sf::Event::MouseButtonPressed;
+        event.mouseButton = {sf::Mouse::Button::Left, x, y};
+        events.push_back({eventFrame, event});
+        event.type = sf::Event::MouseButtonReleased;
+        events.push_back({eventFrame, event});
+      }
+    } else if (command == "PRESS" || command == "RELEASE") {
+      std::string keybind;
+      if (!(line >> keybind)) {
+        throw std::runtime_error("Invalid line in the input script: " + lineStr);
+      }
+      event.type = (command == "PRESS") ? sf::Event::KeyPressed : sf::Event::KeyReleased;
+      event.key = {sf::Keyboard::Key::Unknown, config.getKeybind(keybind), false, false, false, false};
+      events.push_back({eventFrame, event});
+    } else if (command == "CLOSE") {
+      event.type = sf::Event::Closed;
+      events.push_back({eventFrame, event});
+    } else {
+      throw std::runtime_error("Unknown command in the input script: " + lineStr);
+    }
+  }
+
+  // The lines don't have to be in order
+  std::stable_sort(events.begin(), events.end(), [](const ScriptedEvent& a, const ScriptedEvent& b) {
+    return a.frame < b.frame;
+  });
+  this->script = std::move(events);
+  this->nextEvent = 0;
+}
+
+bool NullPlatform::pollEvent(sf::Event& event) {
+  if (this->nextEvent >= this->script.size() || this->script[this->nextEvent].frame > this->frame) {
+    return false;
+  }
+  event = this->script[this->nextEvent++].event;
+
+  // Keep the mouse and the keyboard in the state that the event leaves them in, like a real window would
+  switch (event.type) {
+    case sf::Event::MouseMoved:
+      this->mousePosition = sf::Vector2i(event.mouseMove.x, event.mouseMove.y);
+      break;
+    case sf::Event::KeyPressed:
+      this->pressedKeys.insert(event.key.scancode);
+      break;
+    case sf::Event::KeyReleased:
+      this->pressedKeys.erase(event.key.scancode);
+      break;
+    default:
+      break;
+  }
+  return true;
+}
+
+void NullPlatform::display() {
+  ++this->frame;
+  // The frame of the last command has been played
+  if (this->nextEvent >= this->script.size()) {
+    this->open = false;
+  }
+}
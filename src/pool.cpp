@@ -0,0 +1,163 @@
+/**
+ * @file pool.cpp
+ * @author Patrick Vreeburg
+ * @brief A work-stealing thread pool for the tools
+ * @version 0.1
+ * @date 2024-06-09
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "../include/pool.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// The index of the worker that runs on this thread. Threads that aren't workers have SIZE_MAX
+thread_local size_t currentWorker = SIZE_MAX;
+// The pool that the worker belongs to, so a task of one pool can push to another pool from the outside
+thread_local WorkStealingPool* currentPool = nullptr;
+
+WorkStealingPool::WorkStealingPool(unsigned int numThreads) {
+  if (numThreads == 0) {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  for (unsigned int i = 0; i < numThreads; ++i) {
+    this->workers.push_back(std::make_unique<Worker>());
+  }
+  for (unsigned int i = 0; i < numThreads; ++i) {
+    this->threads.emplace_back(&WorkStealingPool::run, this, i);
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  this->cancel();
+  this->stopping = true;
+  {
+    std::lock_guard<std::mutex> lock(this->sleepMutex);
+    this->workAvailable.notify_all();
+  }
+  for (std::thread& thread : this->threads) {
+    thread.join();
+  }
+}
+
+void WorkStealingPool::push(Task task) {
+  ++this->pending;
+
+  const size_t INDEX = (currentPool == this) ? currentWorker : this->nextWorker++ % this->workers.size();
+  {
+    std::lock_guard<std::mutex> lock(this->workers[INDEX]->mutex);
+    this->workers[INDEX]->tasks.push_back(std::move(task));
+  }
+
+  std::lock_guard<std::mutex> lock(this->sleepMutex);
+  this->workAvailable.notify_one();
+}
+
+void WorkStealingPool::wait() {
+  std::unique_lock<std::mutex> lock(this->sleepMutex);
+  this->allDone.wait(lock, [this] {return this->pending == 0;});
+  lock.unlock();
+
+  // The error is taken out, so the pool can be used again after it was thrown
+  std::exception_ptr taskError;
+  {
+    std::lock_guard<std::mutex> errorLock(this->errorMutex);
+    taskError.swap(this->error);
+  }
+  if (taskError != nullptr) {
+    std::rethrow_exception(taskError);
+  }
+}
+
+void WorkStealingPool::cancel() {
+  for (std::unique_ptr<Worker>& worker : this->workers) {
+    size_t dropped;
+    {
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      dropped = worker->tasks.size();
+      worker->tasks.clear();
+    }
+    for (size_t i = 0; i < dropped; ++i) {
+      this->finishTask();
+    }
+  }
+}
+
+void WorkStealingPool::finishTask() {
+  if (--this->pending == 0) {
+    std::lock_guard<std::mutex> lock(this->sleepMutex);
+    this->allDone.notify_all();
+  }
+}
+
+bool WorkStealingPool::findTask(const size_t index, Task& task) {
+
+  // The newest task of our own queue
+  {
+    Worker& own = *this->workers[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+
+  // The oldest task of someone else's queue, starting with our neighbour so not everyone steals from worker 0
+  for (size_t i = 1; i < this->workers.size(); ++i) {
+    Worker& victim = *this->workers[(index + i) % this->workers.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      ++this->steals;
+      return true;
+    }
+  }
+
+  return false;
+
+}
+
+void WorkStealingPool::run(const size_t index) {
+
+  currentWorker = index;
+  currentPool = this;
+
+  Task task;
+  while (!this->stopping) {
+    if (this->findTask(index, task)) {
+      try {
+        task(index);
+      } catch (...) {
+        // An exception can't leave the thread, so it waits for wait(). The rest of the work is thrown away, like after a cancel
+        {
+          std::lock_guard<std::mutex> lock(this->errorMutex);
+          if (this->error == nullptr) {
+            this->error = std::current_exception();
+          }
+        }
+        this->cancel();
+      }
+      task = nullptr;
+      this->finishTask();
+      continue;
+    }
+
+    // Nothing to do. Sleep until something gets pushed. The timeout catches work that was pushed between findTask and the wait
+    std::unique_lock<std::mutex> lock(this->sleepMutex);
+    this->workAvailable.wait_for(lock, std::chrono::milliseconds(1));
+  }
+
+}
@@ -0,0 +1,112 @@
+/**
+ * @file preview.cpp
+ * @author Patrick Vreeburg
+ * @brief Predicts the path of the ball while the player places an item
+ * @version 0.1
+ * @date 2024-06-30
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "../include/preview.hpp"
+
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "../include/physics.hpp"
+#include "../include/trajectory.hpp"
+#include "../include/world.hpp"
+
+//////////////////////////////////////
+// TrajectoryPreview
+//////////////////////////////////////
+
+void TrajectoryPreview::update(PhysicsWorld& world, const Placement& newItem) {
+  const bool SAME_ITEM = newItem.itemId == this->item.itemId && newItem.position == this->item.position && newItem.rotation == this->item.rotation;
+  if (this->world != nullptr && SAME_ITEM && world.getRevision() == this->worldRevision) {
+    return;
+  }
+
+  sf::Vector2f boundsMin(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+  sf::Vector2f boundsMax(std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest());
+
+  if (this->world == nullptr || world.getRevision() != this->worldRevision) {
+    this->world = std::make_unique<PhysicsWorld>(world);
+    this->world->reset();
+    this->world->clearEvents();
+    this->hasItemId = false;
+
+    this->item = newItem;
+    this->worldRevision = world.getRevision();
+    this->addItem(boundsMin, boundsMax);
+    this->trajectory.start(*this->world);
+  } else {
+    // Only the item has moved, so everything before the ball came near its old or its new place stays the same
+    this->removeItem(boundsMin, boundsMax);
+    this->item = newItem;
+    this->addItem(boundsMin, boundsMax);
+    if (boundsMin.x > boundsMax.x) {
+      // Neither the old nor the new item has physics
+      return;
+    }
+    this->trajectory.rewind(*this->world, boundsMin, boundsMax);
+  }
+
+  this->done = this->world->isFinished() || this->trajectory.getSteps() >= MAX_TICKS;
+}
+
+size_t TrajectoryPreview::advance(const size_t maxTicks) {
+  size_t taken = 0;
+  while (!this->done && taken < maxTicks) {
+    const bool RUNNING = this->world->tick();
+    this->trajectory.record(*this->world);
+    ++taken;
+    this->done = !RUNNING || this->trajectory.getSteps() >= MAX_TICKS;
+  }
+
+  // Nobody listens to the events of the preview
+  if (this->world != nullptr) this->world->clearEvents();
+  return taken;
+}
+
+void TrajectoryPreview::clear() {
+  this->world.reset();
+  this->item = {-1, sf::Vector2i(), 0.f};
+  this->hasItemId = false;
+  this->trajectory = TrajectoryCache();
+  this->done = true;
+}
+
+void TrajectoryPreview::addItem(sf::Vector2f& boundsMin, sf::Vector2f& boundsMax) {
+  // Only the bounce pad and the booster change the path of the ball
+  if (this->item.itemId != 0 && this->item.itemId != 1) {
+    return;
+  }
+
+  this->itemId = this->world->addItem(this->item);
+  this->hasItemId = true;
+
+  bool isBooster;
+  PhysicsObjects::BouncyObject& collider = this->world->getCollider(PhysicsWorld::USER_KEY | this->itemId, isBooster);
+  boundsMin = sf::Vector2f(std::min(boundsMin.x, collider.getBoundsMin().x), std::min(boundsMin.y, collider.getBoundsMin().y));
+  boundsMax = sf::Vector2f(std::max(boundsMax.x, collider.getBoundsMax().x), std::max(boundsMax.y, collider.getBoundsMax().y));
+}
+
+void TrajectoryPreview::removeItem(sf::Vector2f& boundsMin, sf::Vector2f& boundsMax) {
+  if (!this->hasItemId) {
+    return;
+  }
+
+  bool isBooster;
+  PhysicsObjects::BouncyObject& collider = this->world->getCollider(PhysicsWorld::USER_KEY | this->itemId, isBooster);
+  boundsMin = sf::Vector2f(std::min(boundsMin.x, collider.getBoundsMin().x), std::min(boundsMin.y, collider.getBoundsMin().y));
+  boundsMax = sf::Vector2f(std::max(boundsMax.x, collider.getBoundsMax().x), std::max(boundsMax.y, collider.getBoundsMax().y));
+
+  this->world->removeUserObject(this->itemId);
+  this->hasItemId = false;
+}
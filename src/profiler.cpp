@@ -0,0 +1,155 @@
+/**
+ * @file profiler.cpp
+ * @author Patrick Vreeburg
+ * @brief Times the stages of the frames and saves them as a Chrome trace
+ * @version 0.1
+ * @date 2024-07-31
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "../include/profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//////////////////////////////////////
+// Profiler
+//////////////////////////////////////
+
+Profiler& Profiler::get() {
+  static Profiler profiler;
+  return profiler;
+}
+
+int64_t Profiler::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Profiler::ThreadBuffer& Profiler::getThreadBuffer() {
+  thread_local ThreadBuffer* buffer = nullptr;
+  if (buffer == nullptr) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->buffers.push_back(std::make_unique<ThreadBuffer>());
+    buffer = this->buffers.back().get();
+    buffer->id = this->buffers.size();
+  }
+  return *buffer;
+}
+
+void Profiler::setThreadName(const std::string& name) {
+  ThreadBuffer& buffer = this->getThreadBuffer();
+  std::lock_guard<std::mutex> lock(this->mutex);
+  buffer.name = name;
+}
+
+void Profiler::record(const char* name, const int64_t start, const int64_t end) {
+  ThreadBuffer& buffer = this->getThreadBuffer();
+  const uint64_t INDEX = buffer.written.load(std::memory_order_relaxed);
+
+  // Tell the readers that this slot is about to change before changing it
+  buffer.started.store(INDEX + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  Slot& slot = buffer.slots[INDEX & (BUFFER_SIZE - 1)];
+  slot.name.store(name, std::memory_order_relaxed);
+  slot.start.store(start, std::memory_order_relaxed);
+  slot.end.store(end, std::memory_order_relaxed);
+
+  buffer.written.store(INDEX + 1, std::memory_order_release);
+}
+
+void Profiler::writeTrace(const std::filesystem::path& path, const int64_t since) {
+  struct Scope {
+    const char* name;
+    int64_t start;
+    int64_t end;
+  };
+
+  if (!path.parent_path().empty()) {
+    std::filesystem::create_directories(path.parent_path());
+  }
+  std::ofstream file;
+  file.open(path, std::ios::out | std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error("Couldn't write the trace " + path.string() + ".");
+  }
+
+  file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  bool first = true;
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  for (const std::unique_ptr<ThreadBuffer>& buffer : this->buffers) {
+    const uint64_t WRITTEN = buffer->written.load(std::memory_order_acquire);
+    const uint64_t OLDEST = (WRITTEN > BUFFER_SIZE) ? WRITTEN - BUFFER_SIZE : 0;
+
+    std::vector<Scope> scopes;
+    scopes.reserve(static_cast<size_t>(WRITTEN - OLDEST));
+    for (uint64_t i = OLDEST; i < WRITTEN; ++i) {
+      const Slot& SLOT = buffer->slots[i & (BUFFER_SIZE - 1)];
+      scopes.push_back({SLOT.name.load(std::memory_order_relaxed), SLOT.start.load(std::memory_order_relaxed), SLOT.end.load(std::memory_order_relaxed)});
+    }
+
+    // The thread kept recording while the slots were copied. The ones it started overwriting can't be trusted
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t STARTED = buffer->started.load(std::memory_order_relaxed);
+    const uint64_t VALID = (STARTED > BUFFER_SIZE) ? STARTED - BUFFER_SIZE : 0;
+
+    file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->id
+      << ",\"args\":{\"name\":\"" << (buffer->name.empty() ? "Thread " + std::to_string(buffer->id) : buffer->name) << "\"}}";
+    first = false;
+
+    for (uint64_t i = std::max(OLDEST, VALID); i < WRITTEN; ++i) {
+      const Scope& SCOPE = scopes[static_cast<size_t>(i - OLDEST)];
+      if (SCOPE.end < since) continue;
+      // Chrome traces are in microseconds
+      file << ",\n{\"name\":\"" << SCOPE.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id
+        << ",\"ts\":" << static_cast<double>(SCOPE.start) / 1000.0 << ",\"dur\":" << static_cast<double>(SCOPE.end - SCOPE.start) / 1000.0 << "}";
+    }
+  }
+
+  file << "\n]}\n";
+  if (!file.good()) {
+    throw std::runtime_error("Couldn't write the trace " + path.string() + ".");
+  }
+}
+
+void Profiler::setHitchBudget(const float budgetMs, const std::filesystem::path& directory) {
+  this->hitchBudget = static_cast<int64_t>(static_cast<double>(budgetMs) * 1e6);
+  this->hitchDirectory = directory;
+}
+
+void Profiler::endFrame() {
+  const int64_t NOW = Profiler::now();
+
+  // One hitch often comes with a few slow frames after it. Those are in the dump already
+  if (this->hitchBudget > 0 && this->lastFrameEnd != 0 && NOW - this->lastFrameEnd > this->hitchBudget
+      && this->hitchDumps < MAX_HITCH_DUMPS && (this->hitchDumps == 0 || NOW - this->lastHitchDump > HITCH_HISTORY_NS)) {
+    const std::filesystem::path PATH = std::filesystem::path(this->hitchDirectory).append("hitch" + std::to_string(this->hitchDumps) + ".json");
+    // Losing a dump shouldn't stop the game
+    try {
+      this->writeTrace(PATH, NOW - HITCH_HISTORY_NS);
+      std::clog << "A frame took " << static_cast<double>(NOW - this->lastFrameEnd) / 1e6 << " ms. Saved the trace to " << PATH.string() << std::endl;
+    } catch (const std::exception& e) {
+      std::cerr << "Couldn't save the hitch trace: " << e.what() << std::endl;
+    }
+    ++this->hitchDumps;
+    this->lastHitchDump = NOW;
+  }
+
+  // After the dump, so writing it doesn't make the next frame a hitch too
+  this->lastFrameEnd = Profiler::now();
+}
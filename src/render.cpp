@@ -0,0 +1,86 @@
+/**
+ * @file render.cpp
+ * @author Patrick Vreeburg
+ * @brief Batches the sprites of a frame into as few draw calls as possible
+ * @version 0.1
+ * @date 2024-07-29
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "../include/render.hpp"
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/Graphics/Transform.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "../include/profiler.hpp"
+#include "../include/resources.hpp"
+
+//////////////////////////////////////
+// RenderQueue
+//////////////////////////////////////
+
+void RenderQueue::submit(const Layer layer, const SpriteRegion& sprite, const sf::Transform& transform, const sf::Color color) {
+  const sf::IntRect& RECT = sprite.rect;
+  const sf::Vector2f SIZE(std::abs(static_cast<float>(RECT.width)), std::abs(static_cast<float>(RECT.height)));
+  const sf::FloatRect TEXTURE_RECT(sf::Vector2f(static_cast<float>(RECT.left), static_cast<float>(RECT.top)), sf::Vector2f(static_cast<float>(RECT.width), static_cast<float>(RECT.height)));
+
+  this->commands.push_back({layer, false, sprite.texture.get(), this->quads.size()});
+  this->quads.push_back({sprite.texture, SIZE, TEXTURE_RECT, transform, color});
+}
+
+void RenderQueue::flush(sf::RenderTarget& target) {
+  PROFILE_SCOPE("RenderQueue::flush");
+  // Only by layer, and stable, so everything in a layer stays in the order it was submitted in
+  std::stable_sort(this->commands.begin(), this->commands.end(), [](const Command& a, const Command& b) {
+    return a.layer < b.layer;
+  });
+
+  this->drawCalls = 0;
+  size_t i = 0;
+  while (i < this->commands.size()) {
+    const Command& FIRST = this->commands[i];
+
+    if (FIRST.isDrawable) {
+      target.draw(*this->drawables[FIRST.index]);
+      ++this->drawCalls;
+      ++i;
+      continue;
+    }
+
+    // Every quad of this run (the sprites in a row with the same texture) becomes two triangles in the same vertex array
+    this->batch.clear();
+    for (; i < this->commands.size(); ++i) {
+      const Command& COMMAND = this->commands[i];
+      if (COMMAND.layer != FIRST.layer || COMMAND.isDrawable || COMMAND.texture != FIRST.texture) break;
+
+      const Quad& QUAD = this->quads[COMMAND.index];
+      const sf::Vector2f CORNERS[4] = {{0.f, 0.f}, {QUAD.size.x, 0.f}, {0.f, QUAD.size.y}, {QUAD.size.x, QUAD.size.y}};
+      const float LEFT = QUAD.textureRect.left;
+      const float TOP = QUAD.textureRect.top;
+      const float RIGHT = LEFT + QUAD.textureRect.width;
+      const float BOTTOM = TOP + QUAD.textureRect.height;
+      const sf::Vector2f TEXTURE_CORNERS[4] = {{LEFT, TOP}, {RIGHT, TOP}, {LEFT, BOTTOM}, {RIGHT, BOTTOM}};
+
+      for (const size_t CORNER : {0, 1, 2, 2, 1, 3}) {
+        this->batch.append(sf::Vertex(QUAD.transform.transformPoint(CORNERS[CORNER]), QUAD.color, TEXTURE_CORNERS[CORNER]));
+      }
+    }
+    target.draw(this->batch, FIRST.texture);
+    ++this->drawCalls;
+  }
+
+  this->commands.clear();
+  this->quads.clear();
+  this->drawables.clear();
+}
@@ -0,0 +1,305 @@
+/**
+ * @file replay.cpp
+ * @author Patrick Vreeburg
+ * @brief Records runs and plays them back
+ * @version 0.1
+ * @date 2024-06-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "../include/replay.hpp"
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../include/level_data.hpp"
+#include "../include/world.hpp"
+
+/**
+ * @brief Reads a whole file, byte for byte
+ * @attention Throws an std::runtime_error if the file can't be read
+ *
+ * @param path The path to the file
+ * @return std::string The contents
+ */
+std::string readReplayFile(const std::filesystem::path path) {
+  std::ifstream file;
+  file.open(path, std::ios::in | std::ios::binary);
+
+  if (!file.is_open()) {
+    throw std::runtime_error("Couldn't open " + path.string() + ".");
+  }
+
+  std::ostringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+
+//////////////////////////////////////
+// Replay
+//////////////////////////////////////
+
+void Replay::start(const std::filesystem::path newLevelPath, PhysicsWorld& world, const std::vector<Placement>& newPlacements) {
+  this->levelPath = newLevelPath;
+  this->levelText = readReplayFile(newLevelPath);
+  this->levelHash = Replay::hashText(this->levelText);
+
+  this->unitSize = world.getUnitSize();
+  this->levelSize = world.getLevelSize();
+  this->ballOrigin = world.getBallOrigin();
+  this->ballMass = world.getBall().getMass();
+  this->ballRadius = world.getBall().getRadius();
+
+  this->placements = newPlacements;
+  this->schedule.clear();
+  this->result = ReplayResult();
+}
+
+void Replay::addStep(const float deltaTime) {
+  if (!this->schedule.empty() && this->schedule.back().second == deltaTime) {
+    ++this->schedule.back().first;
+    return;
+  }
+  this->schedule.push_back({1, deltaTime});
+}
+
+void Replay::finish(PhysicsWorld& world) {
+  this->result.steps = this->getStepCount();
+  this->result.ballEnd = world.getBall().getMidpoint();
+  this->result.collectedValue = world.getCollectedValue();
+  this->result.collectedBags.clear();
+  for (const MoneyBagState& bag : world.getMoneyBags()) {
+    this->result.collectedBags.push_back(bag.collected);
+  }
+}
+
+uint32_t Replay::getStepCount() const {
+  uint32_t steps = 0;
+  for (const auto& [count, deltaTime] : this->schedule) {
+    steps += count;
+  }
+  return steps;
+}
+
+ReplayResult Replay::run(std::vector<sf::Vector2f>* trajectory) const {
+  PhysicsWorld world{this->unitSize, this->levelSize, this->ballOrigin, this->ballMass, this->ballRadius};
+
+  if (!this->levelText.empty()) {
+    // The hash is only a check that the text wasn't damaged
+    if (Replay::hashText(this->levelText) != this->levelHash) {
+      throw std::runtime_error("The level in the replay doesn't match its hash.");
+    }
+    LevelData data;
+    parseLevelData(this->levelText, data);
+    world.load(data);
+  } else {
+    if (Replay::hashFile(this->levelPath) != this->levelHash) {
+      throw std::runtime_error("The level file " + this->levelPath.string() + " isn't the one that the replay was recorded with.");
+    }
+    world.loadFromFile(this->levelPath);
+  }
+  for (const Placement& placement : this->placements) {
+    world.addItem(placement);
+  }
+
+  if (trajectory != nullptr) trajectory->clear();
+
+  ReplayResult runResult;
+  bool running = true;
+  for (const auto& [count, deltaTime] : this->schedule) {
+    for (uint32_t i = 0; i < count && running; ++i) {
+      running = world.step(deltaTime);
+      ++runResult.steps;
+      if (trajectory != nullptr) trajectory->push_back(world.getBall().getMidpoint());
+    }
+  }
+
+  runResult.ballEnd = world.getBall().getMidpoint();
+  runResult.collectedValue = world.getCollectedValue();
+  for (const MoneyBagState& bag : world.getMoneyBags()) {
+    runResult.collectedBags.push_back(bag.collected);
+  }
+  return runResult;
+}
+
+bool Replay::verify(std::string& message) const {
+  const ReplayResult PLAYED = this->run();
+
+  std::ostringstream difference;
+  if (PLAYED.steps != this->result.steps) {
+    difference << "the run ended after " << PLAYED.steps << " steps instead of " << this->result.steps << ". ";
+  }
+  // The floats have to be exactly the same, not just close
+  if (PLAYED.ballEnd != this->result.ballEnd) {
+    difference << std::hexfloat << "the ball ended at (" << PLAYED.ballEnd.x << "," << PLAYED.ballEnd.y << ") instead of ("
+      << this->result.ballEnd.x << "," << this->result.ballEnd.y << "). " << std::defaultfloat;
+  }
+  if (PLAYED.collectedValue != this->result.collectedValue) {
+    difference << "the score is " << PLAYED.collectedValue << " instead of " << this->result.collectedValue << ". ";
+  }
+  if (PLAYED.collectedBags != this->result.collectedBags) {
+    difference << "different money bags were collected. ";
+  }
+
+  message = difference.str();
+  return message.empty();
+}
+
+void Replay::saveToFile(const std::filesystem::path path) const {
+  std::ofstream file;
+  file.open(path, std::ios::out | std::ios::trunc);
+
+  if (!file.is_open()) {
+    throw std::runtime_error("Couldn't open the replay file.");
+  }
+
+  // All floats are written in hexadecimal, so they get read back without rounding
+  file << std::hexfloat;
+
+  file << "[Level]\n" << this->levelPath.string() << "\n" << std::hex << this->levelHash << std::dec << "\n\n";
+
+  // Every line of the level gets a '|' in front, so its empty lines and headers don't end the section.
+  // The last line is the part after the last newline, so the text comes back byte for byte
+  file << "[LevelData]\n";
+  std::string_view text = this->levelText;
+  while (true) {
+    const size_t END = text.find('\n');
+    file << "|" << text.substr(0, END) << "\n";
+    if (END == std::string_view::npos) break;
+    text.remove_prefix(END + 1);
+  }
+  file << "\n";
+
+  file << "[World]\n" << this->unitSize << " " << this->levelSize.x << " " << this->levelSize.y << " "
+    << this->ballOrigin.x << " " << this->ballOrigin.y << " " << this->ballMass << " " << this->ballRadius << "\n\n";
+
+  file << "[Placements]\n";
+  for (const Placement& placement : this->placements) {
+    file << static_cast<int>(placement.itemId) << " " << placement.position.x << " " << placement.position.y << " " << placement.rotation << "\n";
+  }
+  file << "\n";
+
+  file << "[Schedule]\n";
+  for (const auto& [count, deltaTime] : this->schedule) {
+    file << count << " " << deltaTime << "\n";
+  }
+  file << "\n";
+
+  file << "[Result]\n" << this->result.steps << " " << this->result.ballEnd.x << " " << this->result.ballEnd.y << " " << this->result.collectedValue << " ";
+  for (const bool collected : this->result.collectedBags) {
+    file << (collected ? '1' : '0');
+  }
+  file << "\n";
+
+  if (!file.good()) {
+    throw std::runtime_error("Couldn't write the replay file.");
+  }
+}
+
+void Replay::loadFromFile(const std::filesystem::path path) {
+  std::ifstream file;
+  file.open(path, std::ios::in);
+
+  if (!file.is_open()) {
+    throw std::runtime_error("Couldn't open the replay file.");
+  }
+
+  this->levelText.clear();
+  this->placements.clear();
+  this->schedule.clear();
+  this->result = ReplayResult();
+
+  std::string section;
+  std::string lineStr;
+  bool readPath = false;
+  bool readLevelLine = false;
+  bool foundResult = false;
+  while (std::getline(file, lineStr)) {
+
+    if (lineStr.empty()) continue;
+    if (lineStr.front() == '[') {
+      section = lineStr;
+      continue;
+    }
+
+    if (section == "[LevelData]") {
+      if (lineStr.front() != '|') {
+        throw std::runtime_error("Invalid line in the replay file: " + lineStr);
+      }
+      if (readLevelLine) this->levelText += '\n';
+      this->levelText.append(lineStr, 1, std::string::npos);
+      readLevelLine = true;
+      continue;
+    }
+
+    // The level path can contain spaces, so it gets the whole line
+    if (section == "[Level]" && !readPath) {
+      this->levelPath = lineStr;
+      readPath = true;
+      continue;
+    }
+
+    // std::stof reads the hexadecimal floats. Stream extraction doesn't on every standard library
+    std::istringstream line(lineStr);
+    std::vector<std::string> words;
+    std::string word;
+    while (line >> word) {
+      words.push_back(word);
+    }
+
+    try {
+      if (section == "[Level]") {
+        this->levelHash = std::stoull(words.at(0), nullptr, 16);
+      } else if (section == "[World]") {
+        this->unitSize = std::stof(words.at(0));
+        this->levelSize = {std::stof(words.at(1)), std::stof(words.at(2))};
+        this->ballOrigin = {std::stof(words.at(3)), std::stof(words.at(4))};
+        this->ballMass = std::stof(words.at(5));
+        this->ballRadius = std::stof(words.at(6));
+      } else if (section == "[Placements]") {
+        this->placements.push_back({static_cast<int8_t>(std::stoi(words.at(0))), sf::Vector2i(std::stoi(words.at(1)), std::stoi(words.at(2))), std::stof(words.at(3))});
+      } else if (section == "[Schedule]") {
+        this->schedule.push_back({static_cast<uint32_t>(std::stoul(words.at(0))), std::stof(words.at(1))});
+      } else if (section == "[Result]") {
+        this->result.steps = static_cast<uint32_t>(std::stoul(words.at(0)));
+        this->result.ballEnd = {std::stof(words.at(1)), std::stof(words.at(2))};
+        this->result.collectedValue = static_cast<uint16_t>(std::stoul(words.at(3)));
+        const std::string BAGS = (words.size() > 4) ? words[4] : "";
+        for (const char bag : BAGS) {
+          this->result.collectedBags.push_back(bag == '1');
+        }
+        foundResult = true;
+      }
+    } catch (const std::exception&) {
+      throw std::runtime_error("Invalid line in the replay file: " + lineStr);
+    }
+  }
+
+  if (!readPath || !foundResult) {
+    throw std::runtime_error("The replay file is incomplete.");
+  }
+}
+
+uint64_t Replay::hashText(std::string_view text) {
+  uint64_t hash = 0xcbf29ce484222325ull;
+  for (const char byte : text) {
+    hash ^= static_cast<unsigned char>(byte);
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+uint64_t Replay::hashFile(const std::filesystem::path path) {
+  return Replay::hashText(readReplayFile(path));
+}
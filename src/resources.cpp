@@ -0,0 +1,280 @@
+/**
+ * @file resources.cpp
+ * @author Patrick Vreeburg
+ * @brief Loads the textures, fonts and sounds once and shares them
+ * @version 0.1
+ * @date 2024-07-14
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "../include/resources.hpp"
+
+#include <SFML/Audio/SoundBuffer.hpp>
+#include <SFML/Graphics/Font.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <ios>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/pool.hpp"
+
+//////////////////////////////////////
+// ResourceCache
+//////////////////////////////////////
+
+template <typename Key, typename Handle>
+Handle ResourceCache::insert(std::map<Key, Handle>& cache, const Key& key, Handle handle) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  // Two threads can load the same file at the same time. Everyone gets the one that was there first
+  Handle& cached = cache[key];
+  if (cached == nullptr) {
+    cached = std::move(handle);
+  }
+  return cached;
+}
+
+TextureHandle ResourceCache::getTexture(const std::filesystem::path& path, const bool smooth) {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->textures.find({path, smooth});
+    if (it != this->textures.end()) {
+      return it->second;
+    }
+  }
+
+  std::shared_ptr<sf::Texture> texture = std::make_shared<sf::Texture>();
+  if (!texture->loadFromFile(path)) {
+    throw std::runtime_error("Couldn't load the texture " + path.string() + ".");
+  }
+  texture->setSmooth(smooth);
+  return this->insert<std::pair<std::filesystem::path, bool>, TextureHandle>(this->textures, {path, smooth}, std::move(texture));
+}
+
+SpriteRegion ResourceCache::getSprite(const std::filesystem::path& path, const bool smooth) {
+  std::filesystem::path page;
+  sf::IntRect rect;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->atlas.find(path.filename().string());
+    if (it != this->atlas.end()) {
+      page = it->second.page;
+      rect = it->second.rect;
+    }
+  }
+
+  if (page.empty()) {
+    const TextureHandle TEXTURE = this->getTexture(path, smooth);
+    return {TEXTURE, sf::IntRect(sf::Vector2i(0, 0), static_cast<sf::Vector2i>(TEXTURE->getSize()))};
+  }
+  return {this->getTexture(page, smooth), rect};
+}
+
+void ResourceCache::loadAtlas(const std::filesystem::path& indexPath) {
+  std::ifstream file;
+  file.open(indexPath, std::ios::in);
+
+  if (!file.is_open()) {
+    throw std::runtime_error("Couldn't open the atlas index " + indexPath.string() + ".");
+  }
+
+  std::vector<std::filesystem::path> pages;
+  std::map<std::string, AtlasEntry> entries;
+
+  std::string section;
+  std::string lineStr;
+  while (std::getline(file, lineStr)) {
+
+    if (lineStr.empty()) continue;
+    if (lineStr.front() == '[') {
+      section = lineStr;
+      continue;
+    }
+
+    std::istringstream line(lineStr);
+    std::vector<std::string> words;
+    std::string word;
+    while (line >> word) {
+      words.push_back(word);
+    }
+
+    try {
+      if (section == "[Pages]") {
+        pages.push_back(indexPath.parent_path() / words.at(0));
+      } else if (section == "[Sprites]") {
+        const std::filesystem::path& PAGE = pages.at(std::stoul(words.at(1)));
+        const sf::Vector2i POSITION(std::stoi(words.at(2)), std::stoi(words.at(3)));
+        const sf::Vector2i SIZE(std::stoi(words.at(4)), std::stoi(words.at(5)));
+        entries[words.at(0)] = {PAGE, sf::IntRect(POSITION, SIZE)};
+      }
+    } catch (const std::exception&) {
+      throw std::runtime_error("Invalid line in the atlas index: " + lineStr);
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(this->mutex);
+  for (std::pair<const std::string, AtlasEntry>& entry : entries) {
+    this->atlas[entry.first] = std::move(entry.second);
+  }
+}
+
+std::filesystem::path ResourceCache::getSpriteFile(const std::filesystem::path& path) {
+  std::lock_guard<std::mutex> lock(this->mutex);
+  auto it = this->atlas.find(path.filename().string());
+  return (it != this->atlas.end()) ? it->second.page : path;
+}
+
+FontHandle ResourceCache::getFont(const std::filesystem::path& path) {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->fonts.find(path);
+    if (it != this->fonts.end()) {
+      return it->second;
+    }
+  }
+
+  std::shared_ptr<sf::Font> font = std::make_shared<sf::Font>();
+  if (!font->loadFromFile(path)) {
+    throw std::runtime_error("Couldn't load the font " + path.string() + ".");
+  }
+  return this->insert<std::filesystem::path, FontHandle>(this->fonts, path, std::move(font));
+}
+
+SoundBufferHandle ResourceCache::getSoundBuffer(const std::filesystem::path& path) {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->soundBuffers.find(path);
+    if (it != this->soundBuffers.end()) {
+      return it->second;
+    }
+  }
+
+  std::shared_ptr<sf::SoundBuffer> buffer = std::make_shared<sf::SoundBuffer>();
+  if (!buffer->loadFromFile(path)) {
+    throw std::runtime_error("Couldn't load the sound " + path.string() + ".");
+  }
+  return this->insert<std::filesystem::path, SoundBufferHandle>(this->soundBuffers, path, std::move(buffer));
+}
+
+TextureHandle ResourceCache::addTexture(const std::filesystem::path& path, const bool smooth, const sf::Image& image) {
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->textures.find({path, smooth});
+    if (it != this->textures.end()) {
+      return it->second;
+    }
+  }
+
+  std::shared_ptr<sf::Texture> texture = std::make_shared<sf::Texture>();
+  if (!texture->loadFromImage(image)) {
+    throw std::runtime_error("Couldn't upload the texture " + path.string() + ".");
+  }
+  texture->setSmooth(smooth);
+  return this->insert<std::pair<std::filesystem::path, bool>, TextureHandle>(this->textures, {path, smooth}, std::move(texture));
+}
+
+void ResourceCache::clear() {
+  std::lock_guard<std::mutex> lock(this->mutex);
+
+  // Only the cache holds these, so nobody is drawing or playing them
+  auto dropUnused = [](auto& cache) {
+    for (auto it = cache.begin(); it != cache.end(); ) {
+      it = (it->second.use_count() == 1) ? cache.erase(it) : std::next(it);
+    }
+  };
+  dropUnused(this->textures);
+  dropUnused(this->fonts);
+  dropUnused(this->soundBuffers);
+}
+
+//////////////////////////////////////
+// AssetPreloader
+//////////////////////////////////////
+
+void AssetPreloader::addTexture(const std::filesystem::path& path, const bool smooth) {
+  // Many sprites can share one atlas page, which only has to be loaded once
+  const std::filesystem::path FILE = this->cache.getSpriteFile(path);
+  for (const TextureJob& job : this->textureJobs) {
+    if (job.path == FILE && job.smooth == smooth) {
+      return;
+    }
+  }
+  this->textureJobs.push_back({FILE, smooth, sf::Image()});
+}
+
+void AssetPreloader::addSoundBuffer(const std::filesystem::path& path) {
+  this->soundJobs.push_back(path);
+}
+
+void AssetPreloader::start(WorkStealingPool& pool) {
+  // The lists don't change anymore, so the workers can each write to their own element without a lock
+  for (size_t i = 0; i < this->textureJobs.size(); ++i) {
+    pool.push([this, i](const size_t) {
+      try {
+        TextureJob& job = this->textureJobs[i];
+        if (!job.image.loadFromFile(job.path)) {
+          throw std::runtime_error("Couldn't load the texture " + job.path.string() + ".");
+        }
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->decoded.push_back(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->error == nullptr) {
+          this->error = std::current_exception();
+        }
+      }
+    });
+  }
+
+  for (size_t i = 0; i < this->soundJobs.size(); ++i) {
+    pool.push([this, i](const size_t) {
+      try {
+        // Sounds don't need the window, so they go into the cache right away
+        this->cache.getSoundBuffer(this->soundJobs[i]);
+        ++this->soundsLoaded;
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        if (this->error == nullptr) {
+          this->error = std::current_exception();
+        }
+      }
+    });
+  }
+}
+
+bool AssetPreloader::upload() {
+  std::vector<size_t> ready;
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->error != nullptr) {
+      std::rethrow_exception(this->error);
+    }
+    ready.swap(this->decoded);
+  }
+
+  for (const size_t INDEX : ready) {
+    TextureJob& job = this->textureJobs[INDEX];
+    this->cache.addTexture(job.path, job.smooth, job.image);
+    // The pixels are on the GPU now
+    job.image = sf::Image();
+    ++this->texturesUploaded;
+  }
+
+  return this->getLoaded() == this->getTotal();
+}
@@ -0,0 +1,332 @@
+/**
+ * @file solver.cpp
+ * @author Patrick Vreeburg
+ * @brief Searches for solutions of a level
+ * @version 0.1
+ * @date 2024-06-09
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "../include/solver.hpp"
+
+#include <SFML/System/Angle.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../include/batch.hpp"
+#include "../include/level_data.hpp"
+#include "../include/math.hpp"
+#include "../include/physics.hpp"
+#include "../include/pool.hpp"
+#include "../include/world.hpp"
+
+// The bounce pad (0) and the booster (1)
+const int8_t NUM_ITEMS = 2;
+// A bounce pad turned around works the same, so it only needs half a circle. A booster needs the whole circle
+const float MAX_ANGLES[NUM_ITEMS] = {180.f, 360.f};
+// The number of last items that run together in one BallBatch. Small enough that the batches still spread over the workers
+const size_t BATCH_SIZE = 64;
+
+LevelSolver::LevelSolver(const std::filesystem::path newLevelPath, const SolverConfig& newConfig) : levelPath(newLevelPath), config(newConfig) {
+
+  // The same level data as Level::initLevel. The worlds of solve() load it too, so the file is only read once
+  this->levelData = loadLevelData(newLevelPath);
+
+  this->inventory.assign(NUM_ITEMS, 0);
+  for (const LevelData::InventoryItem& item : this->levelData->inventory) {
+    // The solver only knows the bounce pad and the booster
+    if (item.itemId >= 0 && item.itemId < NUM_ITEMS) {
+      this->inventory[static_cast<size_t>(item.itemId)] = static_cast<uint16_t>(item.count);
+    }
+  }
+  this->bagsNeeded = this->levelData->moneyBagsNeeded;
+
+  // The positions to try. Stay one unit away from the edges, where the walls are
+  const float UNIT_SIZE = this->config.unitSize;
+  const unsigned int COUNT = static_cast<unsigned int>(std::floor(15.f / this->config.gridStep)) + 1;
+  this->latticeSize = sf::Vector2u(COUNT, COUNT);
+  for (unsigned int y = 0; y < COUNT; ++y) {
+    for (unsigned int x = 0; x < COUNT; ++x) {
+      this->lattice.push_back(sf::Vector2i(
+        static_cast<int>(std::round((1.f + static_cast<float>(x) * this->config.gridStep) * UNIT_SIZE)),
+        static_cast<int>(std::round((1.f + static_cast<float>(y) * this->config.gridStep) * UNIT_SIZE))
+      ));
+    }
+  }
+
+}
+
+LevelSolver::RunResult LevelSolver::simulate(PhysicsWorld& world, const std::vector<Placement>& placements, const RunResult& parent) {
+
+  world.clearUserObjects();
+  size_t lastId = 0;
+  for (const Placement& placement : placements) {
+    lastId = world.addItem(placement);
+  }
+  world.reset();
+
+  std::shared_ptr<TrajectoryCache> trajectory = std::make_shared<TrajectoryCache>();
+  if (parent.trajectory == nullptr || placements.empty()) {
+    trajectory->start(world);
+  } else {
+    // Only the last item is new, so the run is the same as the parent's until the ball comes near it
+    bool isBooster;
+    PhysicsObjects::BouncyObject& item = world.getCollider(PhysicsWorld::USER_KEY | lastId, isBooster);
+    trajectory->rewind(*parent.trajectory, world, item.getBoundsMin(), item.getBoundsMax());
+  }
+
+  // The same ticks as the game, so a solution plays out the same way there
+  while (trajectory->getSteps() < this->config.maxTicks && !world.isFinished()) {
+    world.tick();
+    world.clearEvents();
+    trajectory->record(world);
+  }
+
+  RunResult result;
+  result.ticks = static_cast<unsigned int>(trajectory->getSteps());
+  result.end = world.getBall().getMidpoint();
+  for (const MoneyBagState& bag : world.getMoneyBags()) {
+    result.bags += bag.collected;
+  }
+  result.trajectory = std::move(trajectory);
+  return result;
+
+}
+
+bool LevelSolver::isBlocked(PhysicsWorld& world, const Placement& placement) {
+  // Check if the middle or a corner of the item is in a wall of the level
+  const PhysicsObjects::Points CORNERS = PhysicsObjects::getRectanglePoints(
+    static_cast<sf::Vector2f>(placement.position), getItemSize(placement.itemId) * this->config.unitSize, placement.rotation
+  );
+  for (PhysicsObjects::BouncyObject& object : world.getBouncyObjects().getList()) {
+    const sf::Vector2f MIN = object.getBoundsMin();
+    const sf::Vector2f MAX = object.getBoundsMax();
+    auto inside = [&MIN, &MAX](const sf::Vector2f point) {
+      return point.x > MIN.x && point.x < MAX.x && point.y > MIN.y && point.y < MAX.y;
+    };
+    if (inside(static_cast<sf::Vector2f>(placement.position))) {
+      return true;
+    }
+    for (const sf::Vector2f& corner : CORNERS) {
+      if (inside(corner)) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+bool LevelSolver::markVisited(const std::vector<Placement>& placements) {
+  // The same items in another order give the same run, so sort them
+  std::vector<int64_t> key;
+  for (const Placement& placement : placements) {
+    key.push_back(
+      (static_cast<int64_t>(placement.itemId) << 48) |
+      (static_cast<int64_t>(placement.position.x & 0xFFFF) << 32) |
+      (static_cast<int64_t>(placement.position.y & 0xFFFF) << 16) |
+      static_cast<int64_t>(std::lround(placement.rotation * 8.f) & 0xFFFF)
+    );
+  }
+  std::sort(key.begin(), key.end());
+
+  std::lock_guard<std::mutex> lock(this->visitedMutex);
+  return this->visited.insert(std::move(key)).second;
+}
+
+void LevelSolver::explore(const size_t worker, const std::vector<Placement>& placements, const RunResult& parent) {
+
+  if (this->done) {
+    return;
+  }
+  if (this->config.maxRuns != 0 && this->runs >= this->config.maxRuns) {
+    this->runLimitHit = true;
+    this->done = true;
+    this->pool->cancel();
+    return;
+  }
+
+  PhysicsWorld& world = *this->worlds[worker];
+  const RunResult RESULT = this->simulate(world, placements, parent);
+  ++this->runs;
+
+  // The ball never touched the last item, so this is the same as the state without it
+  if (!placements.empty() && RESULT.ticks == parent.ticks && RESULT.end == parent.end && RESULT.bags == parent.bags) {
+    return;
+  }
+
+  if (RESULT.bags >= this->bagsNeeded) {
+    this->addSolution(placements);
+    return;
+  }
+
+  // After the last item of the inventory, only the result of a run matters. Those states get run in batches (see evaluate)
+  const bool LAST_ITEM = placements.size() + 1 == std::accumulate(this->inventory.begin(), this->inventory.end(), static_cast<size_t>(0));
+  std::vector<Placement> lastItems;
+  const auto PUSH_LAST_ITEMS = [this, &placements, &lastItems, &RESULT]() {
+    if (lastItems.empty()) {
+      return;
+    }
+    this->pool->push([this, placements, lastItems, RESULT](const size_t childWorker) {
+      this->evaluate(childWorker, placements, lastItems, RESULT);
+    });
+    lastItems.clear();
+  };
+
+  const float RADIUS = world.getBall().getRadius();
+  const float STEP = this->config.gridStep * this->config.unitSize;
+  const sf::Vector2f FIRST = static_cast<sf::Vector2f>(this->lattice[0]);
+
+  for (int8_t itemId = 0; itemId < NUM_ITEMS; ++itemId) {
+
+    const size_t USED = static_cast<size_t>(std::count_if(placements.begin(), placements.end(), [itemId](const Placement& placement) {return placement.itemId == itemId;}));
+    if (USED >= this->inventory[itemId]) {
+      continue;
+    }
+
+    // Only try the positions where the item would be close enough to the path of the ball to touch it
+    const float REACH = 0.5f * getLength(getItemSize(itemId)) * this->config.unitSize + RADIUS;
+    std::vector<bool> nearPath(this->lattice.size(), false);
+    for (const sf::Vector2f& point : RESULT.trajectory->getPoints()) {
+      const int MIN_X = std::max(0, static_cast<int>(std::ceil((point.x - REACH - FIRST.x) / STEP)));
+      const int MAX_X = std::min(static_cast<int>(this->latticeSize.x) - 1, static_cast<int>(std::floor((point.x + REACH - FIRST.x) / STEP)));
+      const int MIN_Y = std::max(0, static_cast<int>(std::ceil((point.y - REACH - FIRST.y) / STEP)));
+      const int MAX_Y = std::min(static_cast<int>(this->latticeSize.y) - 1, static_cast<int>(std::floor((point.y + REACH - FIRST.y) / STEP)));
+      for (int y = MIN_Y; y <= MAX_Y; ++y) {
+        for (int x = MIN_X; x <= MAX_X; ++x) {
+          const size_t INDEX = static_cast<size_t>(y) * this->latticeSize.x + static_cast<size_t>(x);
+          if (!nearPath[INDEX] && getDistanceSq(static_cast<sf::Vector2f>(this->lattice[INDEX]), point) <= REACH * REACH) {
+            nearPath[INDEX] = true;
+          }
+        }
+      }
+    }
+
+    for (size_t i = 0; i < this->lattice.size(); ++i) {
+      if (!nearPath[i]) {
+        continue;
+      }
+      for (float angle = 0.f; angle < MAX_ANGLES[itemId]; angle += this->config.angleStep) {
+        const Placement PLACEMENT = {itemId, this->lattice[i], angle};
+        if (this->isBlocked(world, PLACEMENT)) {
+          continue;
+        }
+        std::vector<Placement> child = placements;
+        child.push_back(PLACEMENT);
+        if (!this->markVisited(child)) {
+          continue;
+        }
+        if (LAST_ITEM) {
+          lastItems.push_back(PLACEMENT);
+          if (lastItems.size() == BATCH_SIZE) PUSH_LAST_ITEMS();
+          continue;
+        }
+        this->pool->push([this, child, RESULT](const size_t childWorker) {
+          this->explore(childWorker, child, RESULT);
+        });
+      }
+    }
+
+  }
+
+  PUSH_LAST_ITEMS();
+
+}
+
+void LevelSolver::evaluate(const size_t worker, const std::vector<Placement>& placements, const std::vector<Placement>& items, const RunResult& parent) {
+
+  if (this->done) {
+    return;
+  }
+  if (this->config.maxRuns != 0 && this->runs >= this->config.maxRuns) {
+    this->runLimitHit = true;
+    this->done = true;
+    this->pool->cancel();
+    return;
+  }
+
+  // The world gets the items of the parent, so every ball continues the parent's run with its own new item
+  PhysicsWorld& world = *this->worlds[worker];
+  world.clearUserObjects();
+  for (const Placement& placement : placements) {
+    world.addItem(placement);
+  }
+  world.reset();
+
+  BallBatch& batch = *this->batches[worker];
+  batch.clear();
+  for (const Placement& ITEM : items) {
+    batch.addBall(*parent.trajectory, ITEM);
+  }
+  while (batch.tick(this->config.maxTicks) > 0) {}
+  this->runs += items.size();
+
+  for (size_t i = 0; i < items.size(); ++i) {
+    unsigned int bags = 0;
+    for (size_t bag = 0; bag < world.getMoneyBags().size(); ++bag) {
+      bags += batch.hasCollected(i, bag);
+    }
+    if (bags < this->bagsNeeded) {
+      continue;
+    }
+    std::vector<Placement> solution = placements;
+    solution.push_back(items[i]);
+    this->addSolution(solution);
+  }
+
+}
+
+void LevelSolver::addSolution(const std::vector<Placement>& placements) {
+  std::lock_guard<std::mutex> lock(this->solutionsMutex);
+  if (this->config.maxSolutions == 0 || this->solutions.size() < this->config.maxSolutions) {
+    this->solutions.push_back(placements);
+  }
+  if (this->config.maxSolutions != 0 && this->solutions.size() >= this->config.maxSolutions) {
+    this->done = true;
+    this->pool->cancel();
+  }
+}
+
+std::vector<std::vector<Placement>> LevelSolver::solve() {
+
+  WorkStealingPool workers(this->config.threads);
+  this->pool = &workers;
+  this->threads = workers.size();
+
+  // The level is 17 by 17 units and the ball starts at (2,0), like in the game
+  const float UNIT_SIZE = this->config.unitSize;
+  this->batches.clear();
+  this->worlds.clear();
+  for (size_t i = 0; i < workers.size(); ++i) {
+    this->worlds.push_back(std::make_unique<PhysicsWorld>(UNIT_SIZE, sf::Vector2f(17.f * UNIT_SIZE, 17.f * UNIT_SIZE), sf::Vector2f(2.f * UNIT_SIZE, 0.f), 0.1f, 0.25f * UNIT_SIZE));
+    this->worlds.back()->load(*this->levelData);
+    this->batches.push_back(std::make_unique<BallBatch>(*this->worlds.back()));
+  }
+
+  this->visited.clear();
+  this->solutions.clear();
+  this->runs = 0;
+  this->done = false;
+  this->runLimitHit = false;
+
+  workers.push([this](const size_t worker) {
+    this->explore(worker, {}, RunResult());
+  });
+  workers.wait();
+
+  this->steals = workers.getSteals();
+  this->pool = nullptr;
+  return this->solutions;
+
+}
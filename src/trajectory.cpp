@@ -0,0 +1,109 @@
+/**
+ * @file trajectory.cpp
+ * @author Patrick Vreeburg
+ * @brief Remembers runs, so they can be simulated again from the middle
+ * @version 0.1
+ * @date 2024-07-07
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include "../include/trajectory.hpp"
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <vector>
+
+#include "../include/world.hpp"
+
+//////////////////////////////////////
+// TrajectoryCache
+//////////////////////////////////////
+
+void TrajectoryCache::start(PhysicsWorld& world) {
+  this->points.clear();
+  this->stepBoundsMin.clear();
+  this->stepBoundsMax.clear();
+  this->checkpoints.clear();
+
+  this->points.push_back(world.getBall().getMidpoint());
+  this->checkpoints.push_back({0, WorldState()});
+  world.saveState(this->checkpoints.back().state);
+}
+
+void TrajectoryCache::record(PhysicsWorld& world) {
+  this->points.push_back(world.getBall().getMidpoint());
+  sf::Vector2f boundsMin, boundsMax;
+  world.getStepBounds(boundsMin, boundsMax);
+  this->stepBoundsMin.push_back(boundsMin);
+  this->stepBoundsMax.push_back(boundsMax);
+
+  if (this->getSteps() % CHECKPOINT_INTERVAL == 0) {
+    this->checkpoints.push_back({this->getSteps(), WorldState()});
+    world.saveState(this->checkpoints.back().state);
+  }
+}
+
+size_t TrajectoryCache::findCheckpoint(const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax, const float ballRadius) const {
+  // A collider that the ball touches stays in reach a bit longer than the step itself (see PhysicsWorld::CONTACT_SKIN)
+  const float MARGIN = PhysicsWorld::CONTACT_SKIN * ballRadius;
+
+  size_t firstChanged = this->stepBoundsMin.size();
+  for (size_t i = 0; i < this->stepBoundsMin.size(); ++i) {
+    if (this->stepBoundsMin[i].x - MARGIN <= boundsMax.x && this->stepBoundsMax[i].x + MARGIN >= boundsMin.x &&
+        this->stepBoundsMin[i].y - MARGIN <= boundsMax.y && this->stepBoundsMax[i].y + MARGIN >= boundsMin.y) {
+      firstChanged = i;
+      break;
+    }
+  }
+
+  // Step i starts after i steps, so the checkpoint can be at step i at the latest
+  size_t index = this->checkpoints.size() - 1;
+  while (this->checkpoints[index].step > firstChanged) {
+    --index;
+  }
+  return index;
+}
+
+const WorldState& TrajectoryCache::getRewindState(const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax, const float ballRadius, size_t& step) const {
+  const Checkpoint& CHECKPOINT = this->checkpoints[this->findCheckpoint(boundsMin, boundsMax, ballRadius)];
+  step = CHECKPOINT.step;
+  return CHECKPOINT.state;
+}
+
+size_t TrajectoryCache::rewind(PhysicsWorld& world, const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax) {
+  if (this->isEmpty()) {
+    this->start(world);
+    return 0;
+  }
+
+  const size_t INDEX = this->findCheckpoint(boundsMin, boundsMax, world.getBall().getRadius());
+  const size_t STEP = this->checkpoints[INDEX].step;
+
+  this->points.resize(STEP + 1);
+  this->stepBoundsMin.resize(STEP);
+  this->stepBoundsMax.resize(STEP);
+  this->checkpoints.resize(INDEX + 1);
+
+  world.loadState(this->checkpoints.back().state);
+  return STEP;
+}
+
+size_t TrajectoryCache::rewind(const TrajectoryCache& from, PhysicsWorld& world, const sf::Vector2f& boundsMin, const sf::Vector2f& boundsMax) {
+  if (from.isEmpty()) {
+    this->start(world);
+    return 0;
+  }
+
+  const size_t INDEX = from.findCheckpoint(boundsMin, boundsMax, world.getBall().getRadius());
+  const size_t STEP = from.checkpoints[INDEX].step;
+
+  this->points.assign(from.points.begin(), from.points.begin() + static_cast<std::ptrdiff_t>(STEP + 1));
+  this->stepBoundsMin.assign(from.stepBoundsMin.begin(), from.stepBoundsMin.begin() + static_cast<std::ptrdiff_t>(STEP));
+  this->stepBoundsMax.assign(from.stepBoundsMax.begin(), from.stepBoundsMax.begin() + static_cast<std::ptrdiff_t>(STEP));
+  this->checkpoints.assign(from.checkpoints.begin(), from.checkpoints.begin() + static_cast<std::ptrdiff_t>(INDEX + 1));
+
+  world.loadState(this->checkpoints.back().state);
+  return STEP;
+}
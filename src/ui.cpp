@@ -24,6 +24,7 @@
 #include <cstdint>
 #include <filesystem>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -31,10 +32,22 @@
 
 #include "../include/build.hpp"
 #include "../include/globals.hpp"
+#include "../include/render.hpp"
 #include "../include/config.hpp"
+#include "../include/resources.hpp"
 
 sf::Texture tmpTexture;
 
+/**
+ * @brief Get the background of a TextLabel without a background. It's made on first use, because the default TextLabel can be a global too
+ *
+ * @return const SpriteRegion&
+ */
+const SpriteRegion& getEmptySprite() {
+  static const SpriteRegion EMPTY = {std::make_shared<const sf::Texture>(), sf::IntRect()};
+  return EMPTY;
+}
+
 //////////////////////////////////////
 // Button
 //////////////////////////////////////
@@ -49,14 +62,14 @@ bool UIElements::Button::intersect(const sf::Vector2i pos) {
 }
 
 void UIElements::Button::draw() {
-  sf::Sprite outerSprite(this->outer);
+  sf::Sprite outerSprite(*this->outer.texture, this->outer.rect);
 
-  sf::Text buttonText(Globals::mainFont, this->text);
+  sf::Text buttonText(Globals::getMainFont(), this->text);
 
-  outerSprite.setOrigin(0.5f * static_cast<sf::Vector2f>(this->outer.getSize()));
-  outerSprite.setScale(sf::Vector2f(this->size.x / static_cast<float>(this->outer.getSize().x), this->size.y / static_cast<float>(this->outer.getSize().y)));
+  outerSprite.setOrigin(0.5f * this->outer.getSize());
+  outerSprite.setScale(sf::Vector2f(this->size.x / this->outer.getSize().x, this->size.y / this->outer.getSize().y));
   outerSprite.setPosition(this->position);
-  Globals::window->draw(outerSprite);
+  Globals::renderQueue.submit(RenderQueue::UI, this->outer, outerSprite.getTransform());
 
   if (!this->text.empty()) {
     buttonText.setFillColor(this->textColor);
@@ -75,7 +88,7 @@ void UIElements::Button::draw() {
     buttonText.setOrigin(sf::Vector2f(TEXT_RECT.left + 0.5f * TEXT_RECT.width, TEXT_RECT.top + 0.5f * TEXT_RECT.height));
     
     buttonText.setPosition(this->position);
-    Globals::window->draw(buttonText);
+    Globals::renderQueue.submit(RenderQueue::UI, buttonText);
   }
 }
 
@@ -99,26 +112,25 @@ void UIElements::RunButton::onClick() {
 //////////////////////////////////////
 
 void UIElements::InventoryButton::draw() {
-  sf::Sprite outerSprite(this->getOuterTexture());
-  
-  sf::Texture innerTexture;
+  const SpriteRegion& OUTER = this->getOuterTexture();
+  sf::Sprite outerSprite(*OUTER.texture, OUTER.rect);
 
-  if (!innerTexture.loadFromFile(this->innerPath)) {
-    throw std::runtime_error("Failed to load the item texture.");
+  if (this->inner.texture == nullptr) {
+    this->inner = Globals::getResources().getSprite(this->innerPath);
   }
 
-  sf::Sprite innerSprite(innerTexture);
+  sf::Sprite innerSprite(*this->inner.texture, this->inner.rect);
 
-  outerSprite.setOrigin(0.5f * static_cast<sf::Vector2f>(this->getOuterTexture().getSize()));
-  outerSprite.setScale(sf::Vector2f(this->getSize().x / static_cast<float>(this->getOuterTexture().getSize().x), this->getSize().y / static_cast<float>(this->getOuterTexture().getSize().y)));
+  outerSprite.setOrigin(0.5f * OUTER.getSize());
+  outerSprite.setScale(sf::Vector2f(this->getSize().x / OUTER.getSize().x, this->getSize().y / OUTER.getSize().y));
   outerSprite.setPosition(this->getPosition());
-  Globals::window->draw(outerSprite);
+  Globals::renderQueue.submit(RenderQueue::UI, OUTER, outerSprite.getTransform());
 
-  if (innerTexture.getSize().x != 0 && innerTexture.getSize().y != 0) {
+  if (this->inner.rect.width != 0 && this->inner.rect.height != 0) {
     sf::Vector2f innerSizeVector = this->itemSize * static_cast<sf::Vector2f>(this->getSize());
     sf::Vector2f factors;
 
-    sf::Vector2f textureSize = static_cast<sf::Vector2f>(innerTexture.getSize());
+    sf::Vector2f textureSize = this->inner.getSize();
 
     if (lockAspect) {
       float smallestSide = static_cast<float>( (this->getSize().x < this->getSize().y) ? this->getSize().x : this->getSize().y );
@@ -132,12 +144,12 @@ void UIElements::InventoryButton::draw() {
     innerSprite.setScale(factors);
     sf::Vector2f basePos = this->getPosition();
     innerSprite.setPosition(basePos);
-    Globals::window->draw(innerSprite);
+    Globals::renderQueue.submit(RenderQueue::UI_ICONS, this->inner, innerSprite.getTransform());
   }
 
   if (this->count > -1) {
     std::string countStr = std::to_string(this->count);
-    sf::Text countText(Globals::mainFont, countStr);
+    sf::Text countText(Globals::getMainFont(), countStr);
     countText.setCharacterSize(static_cast<unsigned>(0.25f * this->getSize().x));
     sf::Vector2f sizeF = static_cast<sf::Vector2f>(this->getSize());
 
@@ -147,7 +159,7 @@ void UIElements::InventoryButton::draw() {
 
     countText.setFillColor(sf::Color(255, 255, 255));
 
-    Globals::window->draw(countText);
+    Globals::renderQueue.submit(RenderQueue::UI_ICONS, countText);
   }
 }
 
@@ -160,7 +172,7 @@ void UIElements::InventoryButton::onClick() {
 // Inventory
 //////////////////////////////////////
 
-UIElements::Inventory::Inventory(const std::vector<int8_t>& newItems, const std::vector<int16_t>& newCounts, sf::Texture& buttonOuter)
+UIElements::Inventory::Inventory(const std::vector<int8_t>& newItems, const std::vector<int16_t>& newCounts, const SpriteRegion& buttonOuter)
 : items(newItems), counts(newCounts), outerTexture(buttonOuter) {
   for (unsigned short i = 0; i < newItems.size(); ++i) {
     int8_t item = newItems[i];
@@ -215,7 +227,7 @@ void UIElements::Inventory::draw() {
   // Update the position of the buttons to display the items properly in the center of the screen.
   // If the number of items is odd, make one item the middle one and offset the rest accordingly.
   // If the number of items is even, set the middle to the middle of the screen and offset the items accordingly.
-  sf::Vector2u windowSize = Globals::window->getSize();
+  sf::Vector2u windowSize = Globals::platform->getSize();
 
   sf::Vector2f middle = sf::Vector2f(windowSize.x / 2.f, windowSize.y * 0.9f);
   float offset = 0.f;
@@ -268,14 +280,12 @@ void UIElements::Inventory::draw() {
 // TextLabel
 //////////////////////////////////////
 
-UIElements::TextLabel::TextLabel() : Text(Globals::mainFont), Sprite(tmpTexture), fontSize(0) {};
+UIElements::TextLabel::TextLabel() : Text(Globals::getMainFont()), Sprite(tmpTexture), background(getEmptySprite()), fontSize(0) {};
 
 UIElements::TextLabel::TextLabel(const std::string newText, const sf::Vector2f& newPos, const sf::Vector2f& newSize, const std::filesystem::path backgroundPath, const sf::Color& textColor, const sf::Font& font, const int newFontSize)
- : Text(font, newText), Sprite(tmpTexture), text(newText), pos(newPos), size(newSize), fontSize(newFontSize) {
-  if (!this->background.loadFromFile(backgroundPath)) {
-    throw std::runtime_error("Couldn't load the background of a TextLabel.");
-  }
-  this->setTexture(this->background, true);
+ : Text(font, newText), Sprite(tmpTexture), background(Globals::getResources().getSprite(backgroundPath)), text(newText), pos(newPos), size(newSize), fontSize(newFontSize) {
+  this->setTexture(*this->background.texture);
+  this->setTextureRect(this->background.rect);
 
   const float TEXT_SIZE = 0.7f; // Relative to the background
   if (newFontSize > 0) {
@@ -313,12 +323,13 @@ void UIElements::TextLabel::setText(const std::string newString, const bool mini
   }
 }
 
-void UIElements::TextLabel::draw() {
+void UIElements::TextLabel::draw(const RenderQueue::Layer layer) {
   // Set the right size and position
   sf::Sprite* pSprite = static_cast<sf::Sprite*>(this);
   sf::Text* pText = static_cast<sf::Text*>(this);
 
-  pSprite->setTexture(this->background, true);
+  pSprite->setTexture(*this->background.texture);
+  pSprite->setTextureRect(this->background.rect);
 
   const sf::FloatRect SPRITE_RECT = pSprite->getLocalBounds();
   const sf::FloatRect TEXT_RECT = pText->getLocalBounds();
@@ -330,8 +341,8 @@ void UIElements::TextLabel::draw() {
   pSprite->setPosition(this->pos);
   pText->setPosition(this->pos);
 
-  Globals::window->draw(*pSprite);
-  Globals::window->draw(*pText);
+  Globals::renderQueue.submit(layer, this->background, pSprite->getTransform(), pSprite->getColor());
+  Globals::renderQueue.submit(layer, *pText);
 }
 
 //////////////////////////////////////
@@ -364,7 +375,7 @@ void UIElements::ScoreLabel::setScore(const uint8_t newScore) {
 // EditGUI => TextLabel
 //////////////////////////////////////
 
-UIElements::EditGUI::EditGUI(const sf::Vector2f& newPos, const sf::Vector2f& newSize) : TextLabel("", newPos, newSize, std::filesystem::path(RESOURCES_PATH).append("sprites/blank.png"), sf::Color::White, Globals::mainFont, static_cast<int>(0.5f * Globals::unitSize)) {
+UIElements::EditGUI::EditGUI(const sf::Vector2f& newPos, const sf::Vector2f& newSize) : TextLabel("", newPos, newSize, std::filesystem::path(RESOURCES_PATH).append("sprites/blank.png"), sf::Color::White, Globals::getMainFont(), static_cast<int>(0.5f * Globals::unitSize)) {
   this->setText("F: Move/Rotate\nG: Delete");
 }
 
@@ -401,14 +412,14 @@ void UIElements::EditGUI::drawBackground() {
 
   backgroundShape.setFillColor(sf::Color(20,20,20,65));
 
-  Globals::window->draw(backgroundShape);
+  Globals::renderQueue.submit(RenderQueue::POPUP, backgroundShape);
 }
 
 //////////////////////////////////////
 // BuildGUI => TextLabel
 //////////////////////////////////////
 
-UIElements::BuildGUI::BuildGUI(const sf::Vector2f& newPos, const sf::Vector2f& newSize) : TextLabel("", newPos, newSize, std::filesystem::path(RESOURCES_PATH).append("sprites/blank.png"), sf::Color::White, Globals::mainFont, static_cast<int>(0.5f * Globals::unitSize)) {
+UIElements::BuildGUI::BuildGUI(const sf::Vector2f& newPos, const sf::Vector2f& newSize) : TextLabel("", newPos, newSize, std::filesystem::path(RESOURCES_PATH).append("sprites/blank.png"), sf::Color::White, Globals::getMainFont(), static_cast<int>(0.5f * Globals::unitSize)) {
   this->setText("R: Rotate CCW\nT: Rotate CW\nEsc: Cancel");
 }
 
@@ -470,5 +481,5 @@ void UIElements::BuildGUI::drawBackground() {
 
   backgroundRect.setFillColor(sf::Color(20,20,20,65));
 
-  Globals::window->draw(backgroundRect);
+  Globals::renderQueue.submit(RenderQueue::POPUP, backgroundRect);
 }
\ No newline at end of file
@@ -0,0 +1,553 @@
+/**
+ * @file world.cpp
+ * @author Patrick Vreeburg
+ * @brief Handles the headless simulation of a level
+ * @version 0.1
+ * @date 2024-05-12
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include "../include/world.hpp"
+
+#include <SFML/System/Angle.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../include/level_data.hpp"
+#include "../include/math.hpp"
+#include "../include/physics.hpp"
+#include "../include/profiler.hpp"
+
+const short NULL_VALUE = -1;
+
+// The 8 points on the ball that intersectMoneyBag checks, as directions from the midpoint: every 45 degrees, starting at (1,0)
+const float HALF_SQRT2 = 0.70710678f;
+const sf::Vector2f BALL_CHECK_DIRECTIONS[8] = {
+  {1.f, 0.f}, {HALF_SQRT2, HALF_SQRT2}, {0.f, 1.f}, {-HALF_SQRT2, HALF_SQRT2},
+  {-1.f, 0.f}, {-HALF_SQRT2, -HALF_SQRT2}, {0.f, -1.f}, {HALF_SQRT2, -HALF_SQRT2}
+};
+
+//////////////////////////////////////
+// BouncyObjects
+//////////////////////////////////////
+
+void BouncyObjects::makeWalls(const sf::Vector2f levelSize, const float unitSize) {
+
+  PhysicsObjects::BouncyObject floor;
+  floor.setPoints({
+    sf::Vector2f(0.5f * unitSize, levelSize.y - 0.5f * unitSize), 
+    sf::Vector2f(levelSize.x - 0.5f * unitSize, levelSize.y - 0.5f * unitSize), 
+    sf::Vector2f(levelSize.x - 0.5f * unitSize, levelSize.y + 100.f),
+    sf::Vector2f(0.5f * unitSize, levelSize.y + 100.f)
+  });
+  floor.setCOR(0.8f);
+  this->bo_list.push_back(floor);
+
+  PhysicsObjects::BouncyObject right_wall;
+  right_wall.setPoints({
+    sf::Vector2f(levelSize.x - 0.5f * unitSize, 0.5f * unitSize), 
+    sf::Vector2f(levelSize.x + 100.f, 0.5f * unitSize),
+    sf::Vector2f(levelSize.x + 100.f, levelSize.y - 0.5f * unitSize),
+    sf::Vector2f(levelSize.x - 0.5f * unitSize, levelSize.y - 0.5f * unitSize)
+  });
+  right_wall.setCOR(0.8f);
+  this->bo_list.push_back(right_wall);
+
+  PhysicsObjects::BouncyObject ceiling1, ceiling2;
+  ceiling1.setPoints({
+    sf::Vector2f(0.5f * unitSize, 0.5f * unitSize), 
+    sf::Vector2f(1.5f * unitSize, 0.5f * unitSize),
+    sf::Vector2f(1.5f * unitSize, -100.f),
+    sf::Vector2f(0.5f * unitSize, -100.f)
+  });
+  ceiling1.setCOR(0.8f);
+  this->bo_list.push_back(ceiling1);
+
+  ceiling2.setPoints({
+    sf::Vector2f(2.5f * unitSize, 0.5f * unitSize), 
+    sf::Vector2f(levelSize.x - 0.5f * unitSize, 0.5f * unitSize),
+    sf::Vector2f(levelSize.x - 0.5f * unitSize, -100),
+    sf::Vector2f(2.5f * unitSize, -100.f)
+  });
+  ceiling2.setCOR(0.8f);
+  this->bo_list.push_back(ceiling2);
+
+  PhysicsObjects::BouncyObject left_wall;
+  left_wall.setPoints({
+    sf::Vector2f(0.5f * unitSize, 0.5f * unitSize), 
+    sf::Vector2f(-100.f, 0.5f * unitSize),
+    sf::Vector2f(-100.f, levelSize.y - 0.5f * unitSize),
+    sf::Vector2f(0.5f * unitSize, levelSize.y - 0.5f * unitSize)
+  });
+  left_wall.setCOR(0.8f);
+  this->bo_list.push_back(left_wall);
+
+}
+
+void BouncyObjects::makeBO(const PhysicsObjects::Points& points, const float cor, const sf::Vector2f orientation) {
+
+  PhysicsObjects::BouncyObject obj;
+  obj.setPoints(points);
+  obj.setCOR(cor);
+  obj.setOrientation(getNormalized(orientation));
+
+  this->bo_list.push_back(obj);
+
+}
+
+void BouncyObjects::load(const LevelData& data, const float unitSize) {
+
+  for (const LevelData::Collider& collider : data.colliders) {
+
+    // The rectangle covers its tiles, which are drawn half a unit to the top-left
+    const sf::Vector2f START = unitSize * collider.start - sf::Vector2f(0.5f * unitSize, 0.5f * unitSize);
+    const sf::Vector2f END = unitSize * collider.end + sf::Vector2f(unitSize, unitSize) - sf::Vector2f(0.5f * unitSize, 0.5f * unitSize);
+
+    this->makeBO({sf::Vector2f(START.x, START.y), sf::Vector2f(END.x, START.y), sf::Vector2f(END.x, END.y), sf::Vector2f(START.x, END.y)}, collider.cor, collider.orientation);
+
+  }
+
+}
+
+//////////////////////////////////////
+// MoneyBagState
+//////////////////////////////////////
+
+bool intersectMoneyBag(const sf::Vector2f& bagPos, const float unitSize, PhysicsObjects::Ball& ball) {
+  return intersectMoneyBag(bagPos, unitSize, ball.getMidpoint(), ball.getRadius());
+}
+
+bool intersectMoneyBag(const sf::Vector2f& bagPos, const float unitSize, const sf::Vector2f& midpoint, const float radius) {
+  const PhysicsObjects::Points points = {
+    bagPos + sf::Vector2f(-0.3f * unitSize, 0.5f * unitSize),
+    bagPos + sf::Vector2f(0.3f * unitSize, 0.5f * unitSize),
+    bagPos + sf::Vector2f(0.3f * unitSize, -0.5f * unitSize),
+    bagPos + sf::Vector2f(-0.3f * unitSize, -0.5f * unitSize),
+  };
+  // The ball can't touch the bag when it's further away than the corners of the bag
+  const float REACH = getDistance(bagPos, points[0]) + radius;
+  if (getDistanceSq(midpoint, bagPos) > REACH * REACH) {
+    return false;
+  }
+
+  // Now, out of simplicity I use AABB to check if at least one of 8 points on the ball is in the bag
+  for (unsigned short i = 0; i < 8; ++i) {
+    const sf::Vector2f checkPoint = midpoint + radius * BALL_CHECK_DIRECTIONS[i];
+
+    if (checkPoint.x >= points[0].x && checkPoint.x <= points[1].x && checkPoint.y <= points[0].y && checkPoint.y >= points[2].y) {
+      return true;
+    }
+  }
+  return false;
+}
+
+//////////////////////////////////////
+// Placement
+//////////////////////////////////////
+
+sf::Vector2f getItemSize(const int8_t itemId) {
+  switch (itemId) {
+    case 0:
+      return sf::Vector2f(2, 1);
+    case 1:
+      return sf::Vector2f(2, 0.5f);
+    default:
+      throw std::runtime_error("Item " + std::to_string(itemId) + " has no physics.");
+  }
+}
+
+//////////////////////////////////////
+// PhysicsWorld
+//////////////////////////////////////
+
+void PhysicsWorld::load(const LevelData& data) {
+
+  this->bouncyObjects.getList().clear();
+  this->bouncyObjects.makeWalls(this->levelSize, this->unitSize);
+  this->bouncyObjects.load(data, this->unitSize);
+
+  // Index everything in the grid again. The user's objects stay
+  this->grid.clear();
+  for (size_t i = 0; i < this->bouncyObjects.getList().size(); ++i) {
+    PhysicsObjects::BouncyObject& object = this->bouncyObjects.getList()[i];
+    this->grid.insert(i, object.getBoundsMin(), object.getBoundsMax());
+  }
+  for (auto& [id, obj] : this->userObjects) {
+    this->insertUserObject(id);
+  }
+  ++this->revision;
+
+  this->moneyBagOrigins.clear();
+  for (const sf::Vector2f& pos : data.moneyBags) {
+    this->moneyBagOrigins.push_back(this->unitSize * pos);
+  }
+
+  this->reset();
+
+}
+
+PhysicsObjects::BouncyObject& PhysicsWorld::getCollider(const size_t key, bool& isBooster) {
+  if (key < USER_KEY) {
+    isBooster = false;
+    return this->bouncyObjects.getList()[key];
+  }
+  UserObject& obj = this->userObjects.at(key & ~USER_KEY);
+  isBooster = obj.isBooster;
+  if (obj.isBooster) {
+    return obj.booster;
+  }
+  return obj.bouncyObject;
+}
+
+void PhysicsWorld::insertUserObject(const size_t id) {
+  bool isBooster;
+  PhysicsObjects::BouncyObject& collider = this->getCollider(USER_KEY | id, isBooster);
+  this->grid.insert(USER_KEY | id, collider.getBoundsMin(), collider.getBoundsMax());
+  ++this->revision;
+}
+
+size_t PhysicsWorld::addBouncyObject(const PhysicsObjects::BouncyObject& object) {
+  this->userObjects.emplace(this->nextId, UserObject{false, object, PhysicsObjects::Booster()});
+  this->insertUserObject(this->nextId);
+  return this->nextId++;
+}
+
+size_t PhysicsWorld::addBooster(const PhysicsObjects::Booster& booster) {
+  this->userObjects.emplace(this->nextId, UserObject{true, PhysicsObjects::BouncyObject(), booster});
+  this->insertUserObject(this->nextId);
+  return this->nextId++;
+}
+
+size_t PhysicsWorld::addItem(const Placement& placement) {
+  const UserObject OBJECT = PhysicsWorld::makeUserObject(placement, this->unitSize);
+  if (OBJECT.isBooster) {
+    return this->addBooster(OBJECT.booster);
+  }
+  return this->addBouncyObject(OBJECT.bouncyObject);
+}
+
+PhysicsWorld::UserObject PhysicsWorld::makeUserObject(const Placement& placement, const float unitSize) {
+  const sf::Vector2f SIZE = getItemSize(placement.itemId);
+  if (placement.itemId == 1) {
+    return {true, PhysicsObjects::BouncyObject(), PhysicsObjects::Booster(placement.position, SIZE, placement.rotation, unitSize, 0.3f)};
+  }
+  return {false, PhysicsObjects::makeBouncePad(placement.position, SIZE, placement.rotation, unitSize, 0.95f), PhysicsObjects::Booster()};
+}
+
+void PhysicsWorld::removeUserObject(const size_t id) {
+  if (this->userObjects.find(id) == this->userObjects.end()) {
+    return;
+  }
+
+  bool isBooster;
+  PhysicsObjects::BouncyObject& collider = this->getCollider(USER_KEY | id, isBooster);
+  this->grid.remove(USER_KEY | id, collider.getBoundsMin(), collider.getBoundsMax());
+  this->touchingKeys.erase(std::remove(this->touchingKeys.begin(), this->touchingKeys.end(), USER_KEY | id), this->touchingKeys.end());
+
+  this->userObjects.erase(id);
+  ++this->revision;
+}
+
+void PhysicsWorld::clearUserObjects() {
+  while (!this->userObjects.empty()) {
+    this->removeUserObject(this->userObjects.begin()->first);
+  }
+}
+
+void PhysicsWorld::reset() {
+  this->ball.setMidpoint(this->ballOrigin);
+  this->ball.setVelocity(sf::Vector2f());
+
+  this->moneyBags.clear();
+  for (const sf::Vector2f& origin : this->moneyBagOrigins) {
+    this->moneyBags.push_back({origin});
+  }
+
+  for (PhysicsObjects::BouncyObject& object : this->bouncyObjects.getList()) {
+    object.setJustBounced(NULL_VALUE);
+  }
+  for (auto& [id, obj] : this->userObjects) {
+    obj.bouncyObject.setJustBounced(NULL_VALUE);
+    obj.booster.setJustBoosted(false);
+  }
+  this->touchingKeys.clear();
+
+  this->finished = false;
+}
+
+void PhysicsWorld::saveState(WorldState& state) {
+  state.ballMidpoint = this->ball.getMidpoint();
+  state.ballVelocity = this->ball.getVelocityVector();
+
+  state.collected.resize(this->moneyBags.size());
+  for (size_t i = 0; i < this->moneyBags.size(); ++i) {
+    state.collected[i] = this->moneyBags[i].collected;
+  }
+
+  state.touching.clear();
+  for (const size_t KEY : this->touchingKeys) {
+    bool isBooster;
+    PhysicsObjects::BouncyObject& collider = this->getCollider(KEY, isBooster);
+    size_t savedKey = KEY;
+    if (KEY >= USER_KEY) {
+      savedKey = USER_KEY | static_cast<size_t>(std::distance(this->userObjects.begin(), this->userObjects.find(KEY & ~USER_KEY)));
+    }
+    state.touching.push_back({savedKey, collider.getJustBounced(), isBooster && static_cast<PhysicsObjects::Booster&>(collider).getJustBoosted()});
+  }
+
+  state.finished = this->finished;
+}
+
+void PhysicsWorld::loadState(const WorldState& state) {
+  if (state.collected.size() != this->moneyBags.size()) {
+    throw std::runtime_error("The state belongs to another level.");
+  }
+
+  this->ball.setMidpoint(state.ballMidpoint);
+  this->ball.setVelocity(state.ballVelocity);
+
+  for (size_t i = 0; i < this->moneyBags.size(); ++i) {
+    this->moneyBags[i].collected = state.collected[i];
+  }
+
+  // Only the objects in touchingKeys can have a flag set (see checkCollisions)
+  for (const size_t KEY : this->touchingKeys) {
+    bool isBooster;
+    PhysicsObjects::BouncyObject& collider = this->getCollider(KEY, isBooster);
+    collider.setJustBounced(NULL_VALUE);
+    if (isBooster) {
+      static_cast<PhysicsObjects::Booster&>(collider).setJustBoosted(false);
+    }
+  }
+  this->touchingKeys.clear();
+
+  for (const WorldState::Touching& touching : state.touching) {
+    size_t key;
+    if (!this->getStateKey(touching.key, key)) {
+      continue;
+    }
+    bool isBooster;
+    PhysicsObjects::BouncyObject& collider = this->getCollider(key, isBooster);
+    collider.setJustBounced(touching.justBounced);
+    if (isBooster) {
+      static_cast<PhysicsObjects::Booster&>(collider).setJustBoosted(touching.justBoosted);
+    }
+    this->touchingKeys.push_back(key);
+  }
+
+  this->finished = state.finished;
+}
+
+bool PhysicsWorld::getStateKey(const size_t stateKey, size_t& key) {
+  key = stateKey;
+  if (stateKey < USER_KEY) {
+    return true;
+  }
+
+  const size_t INDEX = stateKey & ~USER_KEY;
+  if (INDEX >= this->userObjects.size()) {
+    return false;
+  }
+  key = USER_KEY | std::next(this->userObjects.begin(), static_cast<std::ptrdiff_t>(INDEX))->first;
+  return true;
+}
+
+float PhysicsWorld::getSubstep(const float maxTime) {
+  return PhysicsWorld::getSubstep(maxTime, this->ball.getVelocity(), this->ball.getRadius());
+}
+
+float PhysicsWorld::getSubstep(const float maxTime, const float speed, const float radius) {
+  float substep = std::min(maxTime, MAX_SUBSTEP);
+
+  if (speed * substep > radius) {
+    substep = std::max(radius / speed, std::min(maxTime, MIN_SUBSTEP));
+  }
+  return substep;
+}
+
+bool PhysicsWorld::checkCollisions() {
+  PROFILE_SCOPE("PhysicsWorld::checkCollisions");
+
+  // Stop the simulation when the ball has glitched through a wall of the floor and is outside of the level
+  const sf::Vector2f MID = this->ball.getMidpoint();
+  if (MID.x < 0 || MID.x > this->levelSize.x || MID.y < 0 || MID.y > this->levelSize.y) {
+    return true;
+  }
+
+  // The bouncing itself happens in sweep(). This only checks if the ball is still touching the objects it touched.
+  // Every other object has justBounced and justBoosted cleared already, so there is no need to look at those
+  for (size_t i = 0; i < this->touchingKeys.size(); ) {
+    bool isBooster;
+    PhysicsObjects::BouncyObject& collider = this->getCollider(this->touchingKeys[i], isBooster);
+    const bool TOUCHING = collider.checkCircleCollision(MID, (1.f + CONTACT_SKIN) * this->ball.getRadius(), this->ball.getDirection()) != NULL_VALUE;
+
+    if (isBooster) {
+      if (!TOUCHING) {
+        static_cast<PhysicsObjects::Booster&>(collider).setJustBoosted(false);
+      }
+    } else {
+      if (!TOUCHING) {
+        // This prevents the ball from inevitably staying in the first object it made contact with
+        collider.setJustBounced(NULL_VALUE);
+      } else if (this->ball.getVelocity() < REST_VELOCITY) {
+        // Stop the simulation right before the ball falls through the ground
+        return true;
+      }
+    }
+
+    if (TOUCHING) {
+      ++i;
+    } else {
+      this->touchingKeys.erase(this->touchingKeys.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+  }
+
+  return false;
+
+}
+
+bool PhysicsWorld::sweep(float deltaTime) {
+
+  // Move the ball to the first thing it hits, bounce or boost it there and move on with the rest of the step.
+  // This way a fast ball or a long step can't tunnel through a thin wall.
+  for (unsigned short i = 0; i < MAX_SWEEPS && deltaTime > 0; ++i) {
+
+    // Physics is y-up, SFML is y-down (see Ball::updatePoistion)
+    const sf::Vector2f VELOCITY = this->ball.getDirection() * this->ball.getVelocity();
+    const sf::Vector2f DISPLACEMENT(VELOCITY.x * deltaTime, -VELOCITY.y * deltaTime);
+
+    // Only look at the colliders in the cells that the ball moves through
+    const sf::Vector2f START = this->ball.getMidpoint();
+    const sf::Vector2f END = START + DISPLACEMENT;
+    const float RADIUS = this->ball.getRadius();
+    const sf::Vector2f QUERY_MIN(std::min(START.x, END.x) - RADIUS, std::min(START.y, END.y) - RADIUS);
+    const sf::Vector2f QUERY_MAX(std::max(START.x, END.x) + RADIUS, std::max(START.y, END.y) + RADIUS);
+    this->grid.query(QUERY_MIN, QUERY_MAX, this->nearbyKeys);
+    this->stepBoundsMin = sf::Vector2f(std::min(this->stepBoundsMin.x, QUERY_MIN.x), std::min(this->stepBoundsMin.y, QUERY_MIN.y));
+    this->stepBoundsMax = sf::Vector2f(std::max(this->stepBoundsMax.x, QUERY_MAX.x), std::max(this->stepBoundsMax.y, QUERY_MAX.y));
+
+    float earliest = 2.f;
+    int earliestSide = NULL_VALUE;
+    size_t hitKey = 0;
+
+    float toi;
+    int side;
+    for (const size_t KEY : this->nearbyKeys) {
+      bool isBooster;
+      PhysicsObjects::BouncyObject& collider = this->getCollider(KEY, isBooster);
+      // A booster is not solid. It only boosts the ball once when it enters
+      if (isBooster && static_cast<PhysicsObjects::Booster&>(collider).getJustBoosted()) {
+        continue;
+      }
+      if ((side = collider.sweepBallCollision(this->ball, DISPLACEMENT, toi)) != NULL_VALUE && toi < earliest) {
+        earliest = toi;
+        earliestSide = side;
+        hitKey = KEY;
+      }
+    }
+
+    if (earliestSide == NULL_VALUE) {
+      this->ball.updatePoistion(deltaTime);
+      return false;
+    }
+
+    this->ball.updatePoistion(earliest * deltaTime);
+    deltaTime *= 1.f - earliest;
+
+    if (std::find(this->touchingKeys.begin(), this->touchingKeys.end(), hitKey) == this->touchingKeys.end()) {
+      this->touchingKeys.push_back(hitKey);
+    }
+
+    bool isBooster;
+    PhysicsObjects::BouncyObject& hitObject = this->getCollider(hitKey, isBooster);
+    if (isBooster) {
+      const bool FASTER = static_cast<PhysicsObjects::Booster&>(hitObject).boost(this->ball);
+      this->events.push_back({FASTER ? EventType::BOOST_FASTER : EventType::BOOST_SLOWER, 0});
+    } else {
+      this->events.push_back({(hitKey < USER_KEY) ? EventType::BOUNCE_WALL : EventType::BOUNCE_PAD, 0});
+      hitObject.bounce(this->ball, static_cast<short>(earliestSide));
+      // The ball stops right at the surface, so it has come to rest when a bounce leaves it this slow
+      if (this->ball.getVelocity() < REST_VELOCITY) {
+        return true;
+      }
+    }
+
+  }
+
+  // Out of sweeps: the ball is stuck in a corner, so it doesn't move for the rest of the step
+  return false;
+
+}
+
+bool PhysicsWorld::step(const float deltaTime) {
+  PROFILE_SCOPE("PhysicsWorld::step");
+
+  if (this->finished) {
+    return false;
+  }
+
+  this->ball.applyForce(deltaTime, this->ball.getMass() * (this->unitSize * 9.81f), {0,-1});
+  this->stepBoundsMin = this->ball.getMidpoint();
+  this->stepBoundsMax = this->ball.getMidpoint();
+  if (this->sweep(deltaTime) || this->checkCollisions()) {
+    this->finished = true;
+    return false;
+  }
+
+  // If the ball hits a bag, collect it. The game makes it fall.
+  for (size_t i = 0; i < this->moneyBags.size(); ++i) {
+    MoneyBagState& bag = this->moneyBags[i];
+    if (bag.collected || !intersectMoneyBag(bag.pos, this->unitSize, this->ball)) {
+      continue;
+    }
+    bag.collected = true;
+    this->events.push_back({EventType::MONEY_BAG, i});
+  }
+
+  return true;
+
+}
+
+bool PhysicsWorld::tick() {
+  this->tickSteps.clear();
+  if (this->finished) {
+    return false;
+  }
+
+  // The bounds of the tick cover all of its steps
+  sf::Vector2f boundsMin = this->ball.getMidpoint();
+  sf::Vector2f boundsMax = this->ball.getMidpoint();
+
+  float timeLeft = TICK;
+  bool running = true;
+  while (running && timeLeft > 0) {
+    const float SUBSTEP = this->getSubstep(timeLeft);
+    this->tickSteps.push_back(SUBSTEP);
+    running = this->step(SUBSTEP);
+    timeLeft -= SUBSTEP;
+
+    boundsMin = sf::Vector2f(std::min(boundsMin.x, this->stepBoundsMin.x), std::min(boundsMin.y, this->stepBoundsMin.y));
+    boundsMax = sf::Vector2f(std::max(boundsMax.x, this->stepBoundsMax.x), std::max(boundsMax.y, this->stepBoundsMax.y));
+  }
+
+  this->stepBoundsMin = boundsMin;
+  this->stepBoundsMax = boundsMax;
+  return running;
+}
+
+uint16_t PhysicsWorld::getCollectedValue() {
+  uint16_t value = 0;
+  for (const MoneyBagState& bag : this->moneyBags) {
+    if (bag.collected) value += bag.value;
+  }
+  return value;
+}
@@ -0,0 +1,201 @@
+/**
+ * @file atlas.cpp
+ * @author Patrick Vreeburg
+ * @brief Command line tool that packs the sprites into texture atlases. The build runs it (see CMakeLists.txt)
+ * @version 0.1
+ * @date 2024-07-21
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// The edge pixels of every sprite are repeated this many times around it, so smooth textures don't pick up their neighbours
+const unsigned PADDING = 2;
+// Every GPU that the game runs on can handle textures of this size
+const unsigned DEFAULT_PAGE_SIZE = 2048;
+
+struct PackedSprite {
+  std::string name;
+  sf::Image image;
+  size_t page = 0;
+  sf::Vector2u position; // Of the sprite itself, so without the padding
+};
+
+void printUsage() {
+  std::cout
+    << "Usage: SorryWereBroke_atlas [options] <output.qa> <sprite.png>...\n"
+    << "Packs sprites into as few atlas pages as possible. The pages are written next to the index as <output>0.png, <output>1.png and so on.\n\n"
+    << "Options:\n"
+    << "  --size <pixels>  The maximum width and height of a page (default " << DEFAULT_PAGE_SIZE << ")\n";
+}
+
+/**
+ * @brief Puts the sprites on pages, in rows ("shelves") from the top down. The tallest sprites go first, so every row wastes little height
+ *
+ * @param sprites The sprites. Gets the page and position of each one
+ * @param pageSize The maximum width and height of a page
+ * @return std::vector<sf::Vector2u> The size of every page
+ */
+std::vector<sf::Vector2u> pack(std::vector<PackedSprite>& sprites, const unsigned pageSize) {
+  std::stable_sort(sprites.begin(), sprites.end(), [](const PackedSprite& a, const PackedSprite& b) {
+    return a.image.getSize().y > b.image.getSize().y;
+  });
+
+  std::vector<sf::Vector2u> pages;
+  sf::Vector2u cursor(0, 0);
+  unsigned shelfHeight = 0;
+
+  for (PackedSprite& sprite : sprites) {
+    const sf::Vector2u SLOT = sprite.image.getSize() + sf::Vector2u(2 * PADDING, 2 * PADDING);
+    if (SLOT.x > pageSize || SLOT.y > pageSize) {
+      throw std::runtime_error(sprite.name + " doesn't fit on a page.");
+    }
+
+    // Start a new shelf when the sprite doesn't fit next to the others, and a new page when the shelf doesn't fit under the others
+    if (!pages.empty() && cursor.x + SLOT.x > pageSize) {
+      cursor = sf::Vector2u(0, cursor.y + shelfHeight);
+      shelfHeight = 0;
+    }
+    if (pages.empty() || cursor.y + SLOT.y > pageSize) {
+      pages.push_back(sf::Vector2u(0, 0));
+      cursor = sf::Vector2u(0, 0);
+      shelfHeight = 0;
+    }
+
+    sprite.page = pages.size() - 1;
+    sprite.position = cursor + sf::Vector2u(PADDING, PADDING);
+
+    cursor.x += SLOT.x;
+    shelfHeight = std::max(shelfHeight, SLOT.y);
+    pages.back().x = std::max(pages.back().x, cursor.x);
+    pages.back().y = std::max(pages.back().y, cursor.y + shelfHeight);
+  }
+
+  return pages;
+}
+
+/**
+ * @brief Copies a sprite onto its page, with the edge pixels repeated into the padding
+ *
+ * @param page The page
+ * @param sprite The sprite
+ */
+void draw(sf::Image& page, const PackedSprite& sprite) {
+  const sf::Vector2u SIZE = sprite.image.getSize();
+  const int PAD = static_cast<int>(PADDING);
+
+  for (int y = -PAD; y < static_cast<int>(SIZE.y) + PAD; ++y) {
+    for (int x = -PAD; x < static_cast<int>(SIZE.x) + PAD; ++x) {
+      const unsigned SOURCE_X = static_cast<unsigned>(std::clamp(x, 0, static_cast<int>(SIZE.x) - 1));
+      const unsigned SOURCE_Y = static_cast<unsigned>(std::clamp(y, 0, static_cast<int>(SIZE.y) - 1));
+      const sf::Vector2u DESTINATION(static_cast<unsigned>(static_cast<int>(sprite.position.x) + x), static_cast<unsigned>(static_cast<int>(sprite.position.y) + y));
+      page.setPixel(DESTINATION, sprite.image.getPixel(sf::Vector2u(SOURCE_X, SOURCE_Y)));
+    }
+  }
+}
+
+int main(int argc, char* argv[]) {
+
+  unsigned pageSize = DEFAULT_PAGE_SIZE;
+  std::vector<std::filesystem::path> paths;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string ARG = argv[i];
+    if (ARG == "--help" || ARG == "-h") {
+      printUsage();
+      return EXIT_SUCCESS;
+    } else if (ARG == "--size" && i + 1 < argc) {
+      pageSize = static_cast<unsigned>(std::stoul(argv[++i]));
+    } else if (ARG.rfind("--", 0) == 0) {
+      std::cerr << "Unknown option or missing value: " << ARG << "\n";
+      printUsage();
+      return EXIT_FAILURE;
+    } else {
+      paths.push_back(ARG);
+    }
+  }
+
+  if (paths.size() < 2) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+
+  try {
+    const std::filesystem::path INDEX_PATH = paths.front();
+    std::vector<PackedSprite> sprites;
+    for (size_t i = 1; i < paths.size(); ++i) {
+      PackedSprite sprite;
+      sprite.name = paths[i].filename().string();
+      if (!sprite.image.loadFromFile(paths[i])) {
+        throw std::runtime_error("Couldn't load " + paths[i].string() + ".");
+      }
+      // The game finds sprites by their file name
+      for (const PackedSprite& other : sprites) {
+        if (other.name == sprite.name) {
+          throw std::runtime_error("There are two sprites called " + sprite.name + ".");
+        }
+      }
+      sprites.push_back(sprite);
+    }
+
+    const std::vector<sf::Vector2u> PAGE_SIZES = pack(sprites, pageSize);
+
+    if (!INDEX_PATH.parent_path().empty()) {
+      std::filesystem::create_directories(INDEX_PATH.parent_path());
+    }
+
+    std::ofstream index;
+    index.open(INDEX_PATH, std::ios::out | std::ios::trunc);
+    if (!index.is_open()) {
+      throw std::runtime_error("Couldn't write the atlas index.");
+    }
+
+    index << "[Pages]\n";
+    for (size_t i = 0; i < PAGE_SIZES.size(); ++i) {
+      const std::string PAGE_NAME = INDEX_PATH.stem().string() + std::to_string(i) + ".png";
+
+      sf::Image page;
+      page.create(PAGE_SIZES[i], sf::Color::Transparent);
+      for (const PackedSprite& sprite : sprites) {
+        if (sprite.page == i) {
+          draw(page, sprite);
+        }
+      }
+      if (!page.saveToFile(INDEX_PATH.parent_path() / PAGE_NAME)) {
+        throw std::runtime_error("Couldn't write " + PAGE_NAME + ".");
+      }
+
+      index << PAGE_NAME << "\n";
+      std::cout << PAGE_NAME << ": " << PAGE_SIZES[i].x << "x" << PAGE_SIZES[i].y << "\n";
+    }
+
+    index << "\n[Sprites]\n";
+    for (const PackedSprite& sprite : sprites) {
+      index << sprite.name << " " << sprite.page << " " << sprite.position.x << " " << sprite.position.y << " " << sprite.image.getSize().x << " " << sprite.image.getSize().y << "\n";
+    }
+
+    if (!index.good()) {
+      throw std::runtime_error("Couldn't write the atlas index.");
+    }
+    std::cout << "Packed " << sprites.size() << " sprites on " << PAGE_SIZES.size() << " page(s)\n";
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,563 @@
+/**
+ * @file bench.cpp
+ * @author Patrick Vreeburg
+ * @brief Command line tool that measures the speed of the physics and collision functions
+ * @version 0.1
+ * @date 2024-06-23
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/batch.hpp"
+#include "../include/level_data.hpp"
+#include "../include/math.hpp"
+#include "../include/physics.hpp"
+#include "../include/trajectory.hpp"
+#include "../include/world.hpp"
+
+//////////////////////////////////////
+// Allocation counter
+//////////////////////////////////////
+
+// Every allocation of the tool goes through these, so a benchmark can count its allocations.
+// The benchmarks run on one thread, so the counter doesn't have to be atomic
+static size_t allocations = 0;
+
+void* operator new(std::size_t size) {
+  ++allocations;
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) return pointer;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+  ++allocations;
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) return pointer;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {std::free(pointer);}
+void operator delete[](void* pointer) noexcept {std::free(pointer);}
+void operator delete(void* pointer, std::size_t) noexcept {std::free(pointer);}
+void operator delete[](void* pointer, std::size_t) noexcept {std::free(pointer);}
+
+//////////////////////////////////////
+// Benchmarks
+//////////////////////////////////////
+
+const float UNIT_SIZE = 57.f;
+const float RADIUS = 0.25f * UNIT_SIZE;
+
+// The results go here, so the compiler can't leave out the work
+volatile float sink = 0.f;
+
+struct BenchResult {
+  std::string name;
+  std::string input;
+  uint64_t iterations;
+  double nsPerOp;
+  double allocsPerOp;
+};
+
+/**
+ * @brief Runs a function until it has run for minTime, a few times over, and keeps the fastest round
+ *
+ * @param name The name of the function that gets measured
+ * @param input What the input looks like
+ * @param minTime The time of one round in seconds
+ * @param op The operation. Gets the iteration number, so it can go through a list of inputs
+ * @return BenchResult
+ */
+BenchResult measure(const std::string& name, const std::string& input, const double minTime, const std::function<void(uint64_t)>& op) {
+  const unsigned short ROUNDS = 5;
+
+  // Find out how many iterations fit in a round
+  uint64_t iterations = 1;
+  while (true) {
+    const auto START = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) op(i);
+    const double SECONDS = std::chrono::duration<double>(std::chrono::steady_clock::now() - START).count();
+    if (SECONDS >= 0.1 * minTime || iterations >= (static_cast<uint64_t>(1) << 40)) break;
+    iterations *= 2;
+  }
+  iterations = std::max<uint64_t>(1, iterations * 10);
+
+  double best = 0.0;
+  size_t roundAllocations = 0;
+  for (unsigned short round = 0; round < ROUNDS; ++round) {
+    const size_t ALLOCATIONS_BEFORE = allocations;
+    const auto START = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) op(i);
+    const double NS = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - START).count();
+    roundAllocations = allocations - ALLOCATIONS_BEFORE;
+    if (round == 0 || NS < best) best = NS;
+  }
+
+  return {name, input, iterations, best / static_cast<double>(iterations), static_cast<double>(roundAllocations) / static_cast<double>(iterations)};
+}
+
+/**
+ * @brief Makes balls at a list of positions, all moving in the same direction
+ *
+ * @param positions The midpoints in pixels
+ * @param velocity The velocity (physics coordinates, so y points up)
+ * @return std::vector<PhysicsObjects::Ball>
+ */
+std::vector<PhysicsObjects::Ball> makeBalls(const std::vector<sf::Vector2f>& positions, const sf::Vector2f velocity) {
+  std::vector<PhysicsObjects::Ball> balls;
+  for (const sf::Vector2f& position : positions) {
+    balls.emplace_back(position, 0.1f, RADIUS);
+    balls.back().setVelocity(velocity);
+  }
+  return balls;
+}
+
+/**
+ * @brief Escapes a string for JSON
+ *
+ */
+std::string jsonString(const std::string& text) {
+  std::string escaped = "\"";
+  for (const char character : text) {
+    if (character == '"' || character == '\\') escaped += '\\';
+    escaped += character;
+  }
+  return escaped + "\"";
+}
+
+//////////////////////////////////////
+// Checks
+//////////////////////////////////////
+
+// A run that takes longer than this many ticks stops, like in the solver
+const uint32_t CHECK_MAX_TICKS = 120 * 60;
+
+/**
+ * @brief Ticks the world until its run ends or reaches CHECK_MAX_TICKS, like LevelSolver::simulate
+ *
+ * @param world The world
+ * @param trajectory Gets every tick when it isn't nullptr
+ * @param ticks The number of ticks before the current state of the world
+ * @return uint32_t The number of ticks of the whole run
+ */
+uint32_t finishRun(PhysicsWorld& world, TrajectoryCache* trajectory, uint32_t ticks) {
+  while (ticks < CHECK_MAX_TICKS && !world.isFinished()) {
+    world.tick();
+    world.clearEvents();
+    if (trajectory != nullptr) trajectory->record(world);
+    ++ticks;
+  }
+  return ticks;
+}
+
+/**
+ * @brief Compares the end of a ball's run in a BallBatch with the end of the world's run, bit for bit
+ *
+ * @param world The world after its run
+ * @param worldTicks The number of ticks of the world's run
+ * @param batch The batch after its run
+ * @param i The index of the ball
+ * @param run A description of the run for the message
+ * @param message Gets the difference
+ * @return true if the runs ended the same
+ */
+bool compareRun(PhysicsWorld& world, const uint32_t worldTicks, BallBatch& batch, const size_t i, const std::string& run, std::string& message) {
+  bool same = worldTicks == batch.getTicks(i) && world.getBall().getMidpoint() == batch.getPosition(i);
+  for (size_t bag = 0; bag < world.getMoneyBags().size(); ++bag) {
+    same = same && world.getMoneyBags()[bag].collected == batch.hasCollected(i, bag);
+  }
+  if (!same) {
+    std::ostringstream difference;
+    difference << std::hexfloat << run << ": PhysicsWorld ended at (" << world.getBall().getMidpoint().x << "," << world.getBall().getMidpoint().y << ") after "
+      << worldTicks << " ticks with " << world.getCollectedValue() << " points, BallBatch at (" << batch.getPosition(i).x << "," << batch.getPosition(i).y
+      << ") after " << batch.getTicks(i) << " ticks with " << batch.getCollectedValue(i) << " points";
+    message = difference.str();
+  }
+  return same;
+}
+
+/**
+ * @brief Runs the same runs through a BallBatch and through PhysicsWorld::tick: balls launched in different directions
+ * and the run of the world with one more item, the way the solver tries its items
+ *
+ * @param world The world with the level. It gets reset, and items get added and removed again
+ * @param message Gets set to the first difference
+ * @return true if every run ended exactly the same
+ */
+bool checkBallBatch(PhysicsWorld& world, std::string& message) {
+  const sf::Vector2f ORIGIN = world.getBallOrigin();
+  const float MASS = world.getBall().getMass();
+  const float BALL_RADIUS = world.getBall().getRadius();
+
+  // Launches
+  BallBatch batch(world);
+  std::vector<sf::Vector2f> velocities;
+  for (float x = -400.f; x <= 400.f; x += 50.f) {
+    for (float y = -200.f; y <= 400.f; y += 100.f) {
+      velocities.push_back(sf::Vector2f(x, y));
+      batch.addBall(ORIGIN, velocities.back(), MASS, BALL_RADIUS);
+    }
+  }
+  while (batch.tick(CHECK_MAX_TICKS) > 0) {}
+  for (size_t i = 0; i < velocities.size(); ++i) {
+    world.reset();
+    world.getBall().setVelocity(velocities[i]);
+    const uint32_t TICKS = finishRun(world, nullptr, 0);
+    std::ostringstream run;
+    run << "launch (" << velocities[i].x << "," << velocities[i].y << ")";
+    if (!compareRun(world, TICKS, batch, i, run.str(), message)) {
+      return false;
+    }
+  }
+
+  // One more item, starting from the last checkpoint before the ball came near it
+  world.reset();
+  TrajectoryCache base;
+  base.start(world);
+  finishRun(world, &base, 0);
+
+  std::vector<Placement> items;
+  const int UNIT = static_cast<int>(world.getUnitSize());
+  for (int y = 1; y < 17; ++y) {
+    for (int x = 1; x < 17; ++x) {
+      for (int8_t itemId = 0; itemId < 2; ++itemId) {
+        items.push_back({itemId, sf::Vector2i(x * UNIT, y * UNIT), static_cast<float>((x * 37 + y * 11 + itemId * 90) % 360)});
+      }
+    }
+  }
+  batch.clear();
+  for (const Placement& ITEM : items) {
+    batch.addBall(base, ITEM);
+  }
+  while (batch.tick(CHECK_MAX_TICKS) > 0) {}
+  for (size_t i = 0; i < items.size(); ++i) {
+    const size_t ID = world.addItem(items[i]);
+    world.reset();
+    bool isBooster;
+    PhysicsObjects::BouncyObject& collider = world.getCollider(PhysicsWorld::USER_KEY | ID, isBooster);
+    TrajectoryCache trajectory;
+    const uint32_t TICKS = finishRun(world, &trajectory, static_cast<uint32_t>(trajectory.rewind(base, world, collider.getBoundsMin(), collider.getBoundsMax())));
+    std::ostringstream run;
+    run << ((items[i].itemId == 0) ? "bounce pad" : "booster") << " at (" << items[i].position.x << "," << items[i].position.y << ") @" << items[i].rotation;
+    const bool SAME = compareRun(world, TICKS, batch, i, run.str(), message);
+    world.removeUserObject(ID);
+    if (!SAME) {
+      return false;
+    }
+  }
+
+  world.reset();
+  return true;
+}
+
+void printUsage() {
+  std::cout
+    << "Usage: SorryWereBroke_bench [options]\n"
+    << "Measures ns/op and allocations/op of the physics and collision functions and prints the results as JSON.\n\n"
+    << "Options:\n"
+    << "  --filter <text>    Only run the benchmarks with this text in their name or input\n"
+    << "  --min-time <s>     The time of one round of a benchmark. The fastest of 5 rounds counts (default: 0.05)\n"
+    << "  --level <path>     The level file for loadLevelData (default: res/levels/level1.ql)\n"
+    << "  --out <path>       Write the JSON to this file instead of the standard output\n"
+    << "  --check            Only check that BallBatch ends every run exactly like PhysicsWorld (with the level of --level). Exits with a non-zero exit code if it doesn't\n";
+}
+
+int main(int argc, char* argv[]) {
+
+  std::string filter;
+  double minTime = 0.05;
+  std::filesystem::path levelPath = "res/levels/level1.ql";
+  std::filesystem::path outPath;
+  bool checkOnly = false;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string ARG = argv[i];
+    const bool HAS_VALUE = i + 1 < argc;
+    if (ARG == "--help" || ARG == "-h") {
+      printUsage();
+      return EXIT_SUCCESS;
+    } else if (ARG == "--filter" && HAS_VALUE) {
+      filter = argv[++i];
+    } else if (ARG == "--min-time" && HAS_VALUE) {
+      minTime = std::stod(argv[++i]);
+    } else if (ARG == "--level" && HAS_VALUE) {
+      levelPath = argv[++i];
+    } else if (ARG == "--out" && HAS_VALUE) {
+      outPath = argv[++i];
+    } else if (ARG == "--check") {
+      checkOnly = true;
+    } else {
+      std::cerr << "Unknown option or missing value: " << ARG << "\n";
+      printUsage();
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The BallBatch benchmarks only mean something when the batch gives the same runs as the world
+  if (std::filesystem::exists(levelPath)) {
+    PhysicsWorld world(UNIT_SIZE, sf::Vector2f(17.f * UNIT_SIZE, 17.f * UNIT_SIZE), sf::Vector2f(2.f * UNIT_SIZE, 0.f), 0.1f, RADIUS);
+    world.loadFromFile(levelPath);
+    std::string message;
+    if (!checkBallBatch(world, message)) {
+      std::cerr << "BallBatch doesn't match PhysicsWorld: " << message << "\n";
+      return EXIT_FAILURE;
+    }
+    if (checkOnly) {
+      std::cout << "BallBatch matches PhysicsWorld on " << levelPath.string() << "\n";
+      return EXIT_SUCCESS;
+    }
+  } else if (checkOnly) {
+    std::cerr << "Can't check: " << levelPath.string() << " doesn't exist\n";
+    return EXIT_FAILURE;
+  }
+
+  std::vector<BenchResult> results;
+  const auto RUN = [&](const std::string& name, const std::string& input, const std::function<void(uint64_t)>& op) {
+    if (!filter.empty() && name.find(filter) == std::string::npos && input.find(filter) == std::string::npos) return;
+    results.push_back(measure(name, input, minTime, op));
+  };
+
+  // A bounce pad lying flat and one rotated like a player would, both at the same spot
+  const sf::Vector2i PAD_POS(8 * static_cast<int>(UNIT_SIZE), 8 * static_cast<int>(UNIT_SIZE));
+  PhysicsObjects::BouncyObject flatPad = PhysicsObjects::makeBouncePad(PAD_POS, sf::Vector2f(2, 1), 0.f, UNIT_SIZE);
+  PhysicsObjects::BouncyObject rotatedPad = PhysicsObjects::makeBouncePad(PAD_POS, sf::Vector2f(2, 1), 37.f, UNIT_SIZE);
+  PhysicsObjects::Booster booster(PAD_POS, sf::Vector2f(2, 0.5f), 60.f, UNIT_SIZE, 0.3f);
+
+  const sf::Vector2f MID = static_cast<sf::Vector2f>(PAD_POS);
+  const sf::Vector2f FALLING(0.f, -400.f);
+
+  //////////////////////////////////////
+  // BouncyObject::checkBallCollision
+
+  struct CollisionInput {
+    std::string input;
+    PhysicsObjects::BouncyObject* object;
+    std::vector<sf::Vector2f> positions;
+    sf::Vector2f velocity;
+  };
+  const std::vector<CollisionInput> COLLISION_INPUTS = {
+    // Most colliders in a level are far away, so this is the common case
+    {"far away", &flatPad, {MID + sf::Vector2f(-300, -300), MID + sf::Vector2f(250, 310), MID + sf::Vector2f(-280, 200)}, FALLING},
+    {"near, not touching", &flatPad, {MID + sf::Vector2f(0, -0.5f * UNIT_SIZE - 1.5f * RADIUS), MID + sf::Vector2f(UNIT_SIZE + 1.5f * RADIUS, 0)}, FALLING},
+    {"face hit", &flatPad, {MID + sf::Vector2f(-20, -0.5f * UNIT_SIZE - 0.5f * RADIUS), MID + sf::Vector2f(10, -0.5f * UNIT_SIZE - 0.9f * RADIUS), MID + sf::Vector2f(35, -0.5f * UNIT_SIZE - 0.2f * RADIUS)}, FALLING},
+    {"corner hit", &flatPad, {MID + sf::Vector2f(-UNIT_SIZE - 0.5f * RADIUS, -0.5f * UNIT_SIZE - 0.5f * RADIUS), MID + sf::Vector2f(UNIT_SIZE + 0.6f * RADIUS, 0.5f * UNIT_SIZE + 0.6f * RADIUS)}, sf::Vector2f(-300.f, -300.f)},
+    {"rotated pad face hit", &rotatedPad, {MID + sf::Vector2f(-0.3f * UNIT_SIZE, -0.5f * UNIT_SIZE - 0.5f * RADIUS), MID + sf::Vector2f(0.3f * UNIT_SIZE, -0.9f * UNIT_SIZE)}, FALLING},
+    // Just touching, moving along the surface. The sides that are almost parallel to the velocity are the hard ones
+    {"grazing contact", &flatPad, {MID + sf::Vector2f(-30, -0.5f * UNIT_SIZE - 0.999f * RADIUS), MID + sf::Vector2f(30, -0.5f * UNIT_SIZE - 0.999f * RADIUS)}, sf::Vector2f(500.f, -0.01f)},
+    {"ball inside", &flatPad, {MID, MID + sf::Vector2f(5, 5)}, FALLING}
+  };
+  for (const CollisionInput& input : COLLISION_INPUTS) {
+    std::vector<PhysicsObjects::Ball> balls = makeBalls(input.positions, input.velocity);
+    PhysicsObjects::BouncyObject* object = input.object;
+    RUN("BouncyObject::checkBallCollision", input.input, [&balls, object](uint64_t i) {
+      sink = sink + static_cast<float>(object->checkBallCollision(balls[i % balls.size()]));
+    });
+  }
+
+  //////////////////////////////////////
+  // BouncyObject::bounce
+
+  struct BounceInput {
+    std::string input;
+    PhysicsObjects::BouncyObject* object;
+    std::vector<sf::Vector2f> velocities;
+    short side;
+  };
+  const std::vector<BounceInput> BOUNCE_INPUTS = {
+    {"straight down on a flat pad", &flatPad, {sf::Vector2f(0.f, -400.f), sf::Vector2f(0.f, -650.f)}, 0},
+    {"diagonal on a rotated pad", &rotatedPad, {sf::Vector2f(200.f, -350.f), sf::Vector2f(-120.f, -500.f)}, 0},
+    {"grazing", &flatPad, {sf::Vector2f(500.f, -0.01f), sf::Vector2f(-450.f, -0.5f)}, 0},
+    {"corner side", &rotatedPad, {sf::Vector2f(-300.f, -300.f)}, 3}
+  };
+  for (const BounceInput& input : BOUNCE_INPUTS) {
+    PhysicsObjects::Ball ball(MID, 0.1f, RADIUS);
+    PhysicsObjects::BouncyObject* object = input.object;
+    const std::vector<sf::Vector2f> VELOCITIES = input.velocities;
+    const short SIDE = input.side;
+    RUN("BouncyObject::bounce", input.input, [&ball, object, VELOCITIES, SIDE](uint64_t i) {
+      ball.setVelocity(VELOCITIES[i % VELOCITIES.size()]);
+      object->bounce(ball, SIDE);
+      sink = sink + ball.getVelocityVector().x;
+    });
+  }
+
+  //////////////////////////////////////
+  // Booster::boost. The sound is played by the game from the world's events, so this is only the physics
+
+  struct BoostInput {
+    std::string input;
+    std::vector<sf::Vector2f> velocities;
+  };
+  const std::vector<BoostInput> BOOST_INPUTS = {
+    {"with the arrow", {sf::Vector2f(300.f, 170.f), sf::Vector2f(420.f, 250.f)}},
+    {"against the arrow", {sf::Vector2f(-300.f, -170.f), sf::Vector2f(-200.f, -150.f)}},
+    {"almost at rest", {sf::Vector2f(0.01f, -0.02f), sf::Vector2f(-0.001f, 0.f)}}
+  };
+  for (const BoostInput& input : BOOST_INPUTS) {
+    PhysicsObjects::Ball ball(MID, 0.1f, RADIUS);
+    const std::vector<sf::Vector2f> VELOCITIES = input.velocities;
+    RUN("Booster::boost", input.input, [&ball, &booster, VELOCITIES](uint64_t i) {
+      ball.setVelocity(VELOCITIES[i % VELOCITIES.size()]);
+      sink = sink + static_cast<float>(booster.boost(ball));
+    });
+  }
+
+  //////////////////////////////////////
+  // MoneyBag::intersect (the collision itself is intersectMoneyBag)
+
+  struct BagInput {
+    std::string input;
+    std::vector<sf::Vector2f> positions;
+  };
+  const std::vector<BagInput> BAG_INPUTS = {
+    {"far away", {MID + sf::Vector2f(300, 300), MID + sf::Vector2f(-250, 120)}},
+    {"overlapping", {MID, MID + sf::Vector2f(0.2f * UNIT_SIZE, -0.1f * UNIT_SIZE)}},
+    {"touching the edge", {MID + sf::Vector2f(0.5f * UNIT_SIZE + 0.99f * RADIUS, 0), MID + sf::Vector2f(0, -0.5f * UNIT_SIZE - 0.99f * RADIUS)}},
+    {"near a corner", {MID + sf::Vector2f(0.5f * UNIT_SIZE + 0.6f * RADIUS, 0.5f * UNIT_SIZE + 0.6f * RADIUS)}}
+  };
+  for (const BagInput& input : BAG_INPUTS) {
+    std::vector<PhysicsObjects::Ball> balls = makeBalls(input.positions, FALLING);
+    RUN("MoneyBag::intersect", input.input, [&balls, MID](uint64_t i) {
+      sink = sink + static_cast<float>(intersectMoneyBag(MID, UNIT_SIZE, balls[i % balls.size()]));
+    });
+  }
+
+  //////////////////////////////////////
+  // getDistance
+
+  const std::vector<std::pair<sf::Vector2f, sf::Vector2f>> POINT_PAIRS = {
+    {sf::Vector2f(12.5f, 80.25f), sf::Vector2f(500.f, 300.f)},
+    {sf::Vector2f(456.f, 456.f), sf::Vector2f(456.f, 456.01f)},
+    {sf::Vector2f(-1e4f, 3e3f), sf::Vector2f(2e4f, -7e3f)}
+  };
+  RUN("getDistance(point, point)", "mixed", [&POINT_PAIRS](uint64_t i) {
+    const auto& [a, b] = POINT_PAIRS[i % POINT_PAIRS.size()];
+    sink = sink + getDistance(a, b);
+  });
+
+  const std::array<PhysicsObjects::Edge, PhysicsObjects::NUM_SIDES>& EDGES = rotatedPad.getEdges();
+  const std::vector<sf::Vector2f> LINE_POINTS = {MID, MID + sf::Vector2f(40, -60), MID + sf::Vector2f(-300, 250)};
+  RUN("getDistance(line, point)", "sides of a rotated pad", [&EDGES, &LINE_POINTS](uint64_t i) {
+    const PhysicsObjects::Edge& EDGE = EDGES[i % EDGES.size()];
+    sink = sink + getDistance(EDGE.a, EDGE.b, EDGE.c, LINE_POINTS[i % LINE_POINTS.size()]);
+  });
+
+  //////////////////////////////////////
+  // rotateVector (std::sin and std::cos, or the polynomials with SWB_DETERMINISTIC_PHYSICS)
+
+  const std::vector<float> ANGLES = {0.f, 37.f, 90.f, 123.4f, -200.f, 719.8f};
+  RUN("rotateVector", "mixed angles", [&ANGLES](uint64_t i) {
+    sink = sink + rotateVector(sf::Vector2f(57.f, -28.5f), ANGLES[i % ANGLES.size()]).x;
+  });
+
+  //////////////////////////////////////
+  // PhysicsWorld::step (a whole run, to compare a SWB_DETERMINISTIC_PHYSICS build with a normal one)
+
+  if (std::filesystem::exists(levelPath)) {
+    PhysicsWorld world(UNIT_SIZE, sf::Vector2f(17.f * UNIT_SIZE, 17.f * UNIT_SIZE), sf::Vector2f(2.f * UNIT_SIZE, 0.f), 0.1f, RADIUS);
+    world.loadFromFile(levelPath);
+    world.addItem({0, sf::Vector2i(2 * static_cast<int>(UNIT_SIZE), 16 * static_cast<int>(UNIT_SIZE)), 0.f});
+    world.addItem({0, sf::Vector2i(86, 342), 120.f});
+    RUN("PhysicsWorld::step", levelPath.filename().string() + " with two bounce pads", [&world](uint64_t) {
+      if (world.isFinished()) world.reset();
+      world.step(1.f / 60.f);
+      world.clearEvents();
+      sink = sink + world.getBall().getMidpoint().y;
+    });
+  } else {
+    std::cerr << "Skipping PhysicsWorld::step: " << levelPath.string() << " doesn't exist\n";
+  }
+
+  //////////////////////////////////////
+  // BallBatch::tick against PhysicsWorld::tick (the same whole runs, one after the other)
+
+  if (std::filesystem::exists(levelPath)) {
+    PhysicsWorld world(UNIT_SIZE, sf::Vector2f(17.f * UNIT_SIZE, 17.f * UNIT_SIZE), sf::Vector2f(2.f * UNIT_SIZE, 0.f), 0.1f, RADIUS);
+    world.loadFromFile(levelPath);
+    world.addItem({0, sf::Vector2i(2 * static_cast<int>(UNIT_SIZE), 16 * static_cast<int>(UNIT_SIZE)), 0.f});
+    std::vector<sf::Vector2f> launches;
+    for (float x = -300.f; x <= 300.f; x += 40.f) {
+      launches.push_back(sf::Vector2f(x, 100.f));
+    }
+    const std::string INPUT = std::to_string(launches.size()) + " launches in " + levelPath.filename().string();
+
+    BallBatch batch(world);
+    RUN("BallBatch::tick", INPUT, [&world, &batch, &launches](uint64_t) {
+      batch.clear();
+      for (const sf::Vector2f& LAUNCH : launches) {
+        batch.addBall(world.getBallOrigin(), LAUNCH, world.getBall().getMass(), world.getBall().getRadius());
+      }
+      while (batch.tick(CHECK_MAX_TICKS) > 0) {}
+      sink = sink + batch.getPosition(0).y;
+    });
+    RUN("PhysicsWorld::tick", INPUT, [&world, &launches](uint64_t) {
+      for (const sf::Vector2f& LAUNCH : launches) {
+        world.reset();
+        world.getBall().setVelocity(LAUNCH);
+        finishRun(world, nullptr, 0);
+      }
+      sink = sink + world.getBall().getMidpoint().y;
+    });
+  }
+
+  //////////////////////////////////////
+  // loadLevelData (the whole level file: the tilemap, the inventory, the colliders and the money bags)
+
+  if (std::filesystem::exists(levelPath)) {
+    RUN("loadLevelData", levelPath.filename().string(), [&levelPath](uint64_t) {
+      const LevelDataHandle DATA = loadLevelData(levelPath);
+      sink = sink + static_cast<float>(DATA->tilemap[TILEMAP_SIZE - 1][TILEMAP_SIZE - 1]);
+    });
+  } else {
+    std::cerr << "Skipping loadLevelData: " << levelPath.string() << " doesn't exist\n";
+  }
+
+  //////////////////////////////////////
+  // Output
+
+  std::ostringstream json;
+#ifdef SWB_DETERMINISTIC_PHYSICS
+  const bool DETERMINISTIC = true;
+#else
+  const bool DETERMINISTIC = false;
+#endif
+  json << std::setprecision(6) << "{\n  \"unit_size\": " << UNIT_SIZE << ",\n  \"deterministic_physics\": " << (DETERMINISTIC ? "true" : "false") << ",\n  \"benchmarks\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const BenchResult& RESULT = results[i];
+    json << (i == 0 ? "\n" : ",\n")
+      << "    {\"name\": " << jsonString(RESULT.name) << ", \"input\": " << jsonString(RESULT.input)
+      << ", \"iterations\": " << RESULT.iterations << ", \"ns_per_op\": " << RESULT.nsPerOp << ", \"allocs_per_op\": " << RESULT.allocsPerOp << "}";
+  }
+  json << "\n  ]\n}\n";
+
+  if (outPath.empty()) {
+    std::cout << json.str();
+    return EXIT_SUCCESS;
+  }
+  std::ofstream file(outPath, std::ios::out | std::ios::trunc);
+  if (!file.is_open()) {
+    std::cerr << "Couldn't open " << outPath.string() << "\n";
+    return EXIT_FAILURE;
+  }
+  file << json.str();
+  return EXIT_SUCCESS;
+
+}
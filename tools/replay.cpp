@@ -0,0 +1,101 @@
+/**
+ * @file replay.cpp
+ * @author Patrick Vreeburg
+ * @brief Command line tool that plays back and verifies recorded runs
+ * @version 0.1
+ * @date 2024-06-16
+ *
+ * @copyright Copyright (c) 2024
+ *
+ */
+
+#include <SFML/System/Vector2.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/replay.hpp"
+
+void printUsage() {
+  std::cout
+    << "Usage: SorryWereBroke_replay [options] <replay.qr>...\n"
+    << "Plays back runs that the game recorded (see data/replays/lastRun.qr) without a window.\n\n"
+    << "Options:\n"
+    << "  --verify         Check that each run ends exactly like it did in the game. Exits with a non-zero exit code if one doesn't\n"
+    << "  --trace          Print the position of the ball after every step\n"
+    << "  --level <path>   The level file for old replays that don't contain their level. It has to be the same level\n";
+}
+
+int main(int argc, char* argv[]) {
+
+  bool verify = false;
+  bool trace = false;
+  std::filesystem::path levelOverride;
+  std::vector<std::filesystem::path> replays;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string ARG = argv[i];
+    if (ARG == "--help" || ARG == "-h") {
+      printUsage();
+      return EXIT_SUCCESS;
+    } else if (ARG == "--verify") {
+      verify = true;
+    } else if (ARG == "--trace") {
+      trace = true;
+    } else if (ARG == "--level" && i + 1 < argc) {
+      levelOverride = argv[++i];
+    } else if (ARG.rfind("--", 0) == 0) {
+      std::cerr << "Unknown option or missing value: " << ARG << "\n";
+      printUsage();
+      return EXIT_FAILURE;
+    } else {
+      replays.push_back(ARG);
+    }
+  }
+
+  if (replays.empty()) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+
+  std::cout << std::fixed << std::setprecision(2);
+
+  bool allMatch = true;
+  for (const std::filesystem::path& path : replays) {
+
+    try {
+      Replay replay;
+      replay.loadFromFile(path);
+      if (!levelOverride.empty()) replay.setLevelPath(levelOverride);
+
+      if (verify) {
+        std::string message;
+        const bool MATCHES = replay.verify(message);
+        std::cout << path.string() << ": " << (MATCHES ? "OK" : "MISMATCH: " + message) << "\n";
+        allMatch = allMatch && MATCHES;
+        continue;
+      }
+
+      std::vector<sf::Vector2f> trajectory;
+      const ReplayResult RESULT = replay.run(trace ? &trajectory : nullptr);
+
+      std::cout << path.string() << ": " << replay.getLevelPath().string() << ", " << replay.getPlacements().size() << " items, "
+        << RESULT.steps << " steps, score " << RESULT.collectedValue << ", ball ended at (" << RESULT.ballEnd.x << "," << RESULT.ballEnd.y << ")\n";
+      for (size_t i = 0; i < trajectory.size(); ++i) {
+        std::cout << "  " << i + 1 << " " << trajectory[i].x << " " << trajectory[i].y << "\n";
+      }
+    } catch (const std::exception& e) {
+      std::cerr << path.string() << ": " << e.what() << "\n";
+      allMatch = false;
+    }
+
+  }
+
+  return allMatch ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}
@@ -0,0 +1,115 @@
+/**
+ * @file solver.cpp
+ * @author Patrick Vreeburg
+ * @brief Command line tool that checks if levels can be solved with their inventory
+ * @version 0.1
+ * @date 2024-06-09
+ * 
+ * @copyright Copyright (c) 2024
+ * 
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../include/solver.hpp"
+
+void printUsage() {
+  std::cout
+    << "Usage: SorryWereBroke_solver [options] <level.ql>...\n"
+    << "Searches for placements of the bounce pads and boosters in each level's [Inventory] that collect [MoneyBagsNeeded] money bags.\n"
+    << "Positions are in units, with (0,0) in the top-left corner. Rotations are in degrees, clockwise.\n\n"
+    << "Options:\n"
+    << "  --threads <n>      Number of worker threads (default: one per hardware thread)\n"
+    << "  --grid <units>     Distance between the positions that are tried (default: 0.5)\n"
+    << "  --angle <degrees>  Difference between the rotations that are tried (default: 15)\n"
+    << "  --solutions <n>    Stop after this many solutions, 0 for all of them (default: 5)\n"
+    << "  --max-runs <n>     Stop after simulating this many runs, 0 for no limit (default: 0)\n"
+    << "  --unit-size <px>   Pixels per unit (default: 57)\n";
+}
+
+int main(int argc, char* argv[]) {
+
+  SolverConfig config;
+  std::vector<std::filesystem::path> levels;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string ARG = argv[i];
+    const bool HAS_VALUE = i + 1 < argc;
+    if (ARG == "--help" || ARG == "-h") {
+      printUsage();
+      return EXIT_SUCCESS;
+    } else if (ARG == "--threads" && HAS_VALUE) {
+      config.threads = static_cast<unsigned int>(std::stoul(argv[++i]));
+    } else if (ARG == "--grid" && HAS_VALUE) {
+      config.gridStep = std::stof(argv[++i]);
+    } else if (ARG == "--angle" && HAS_VALUE) {
+      config.angleStep = std::stof(argv[++i]);
+    } else if (ARG == "--solutions" && HAS_VALUE) {
+      config.maxSolutions = std::stoul(argv[++i]);
+    } else if (ARG == "--max-runs" && HAS_VALUE) {
+      config.maxRuns = std::stoul(argv[++i]);
+    } else if (ARG == "--unit-size" && HAS_VALUE) {
+      config.unitSize = std::stof(argv[++i]);
+    } else if (ARG.rfind("--", 0) == 0) {
+      std::cerr << "Unknown option or missing value: " << ARG << "\n";
+      printUsage();
+      return EXIT_FAILURE;
+    } else {
+      levels.push_back(ARG);
+    }
+  }
+
+  if (levels.empty() || config.gridStep <= 0 || config.angleStep <= 0) {
+    printUsage();
+    return EXIT_FAILURE;
+  }
+
+  std::cout << std::fixed << std::setprecision(2);
+
+  bool allSolved = true;
+  for (const std::filesystem::path& level : levels) {
+
+    try {
+      LevelSolver solver(level, config);
+
+      const auto START = std::chrono::steady_clock::now();
+      const std::vector<std::vector<Placement>> SOLUTIONS = solver.solve();
+      const double SECONDS = std::chrono::duration<double>(std::chrono::steady_clock::now() - START).count();
+
+      std::cout << level.string() << ": " << (!SOLUTIONS.empty() ? "solvable" : (solver.hitRunLimit() ? "NO SOLUTION FOUND within --max-runs" : "NOT SOLVABLE"))
+        << " (" << solver.getBagsNeeded() << " bags needed, inventory: " << solver.getInventory()[0] << " bounce pads, " << solver.getInventory()[1] << " boosters)\n";
+      std::cout << "  " << solver.getRuns() << " runs in " << SECONDS << " s on " << solver.getThreads() << " threads (" << solver.getSteals() << " steals)\n";
+
+      for (size_t i = 0; i < SOLUTIONS.size(); ++i) {
+        std::cout << "  solution " << i + 1 << ":";
+        if (SOLUTIONS[i].empty()) {
+          std::cout << " no items needed";
+        }
+        for (const Placement& placement : SOLUTIONS[i]) {
+          std::cout << " " << ((placement.itemId == 0) ? "bouncePad" : "booster")
+            << "(" << static_cast<float>(placement.position.x) / config.unitSize << "," << static_cast<float>(placement.position.y) / config.unitSize
+            << " @" << placement.rotation << ")";
+        }
+        std::cout << "\n";
+      }
+
+      allSolved = allSolved && !SOLUTIONS.empty();
+    } catch (const std::exception& e) {
+      std::cerr << level.string() << ": " << e.what() << "\n";
+      allSolved = false;
+    }
+
+  }
+
+  // A non-zero exit code when a level can't be solved, so a script can check a whole level pack
+  return allSolved ? EXIT_SUCCESS : EXIT_FAILURE;
+
+}